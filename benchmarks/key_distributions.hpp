@@ -0,0 +1,51 @@
+#ifndef KEY_DISTRIBUTIONS
+#define KEY_DISTRIBUTIONS
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+// Zipfian ranks in [0, items), rank 0 the most popular. Uses the rejection-free method from
+// Gray et al., "Quickly Generating Billion-Record Synthetic Databases" (as in YCSB).
+// Construction is O(items) to compute the zeta constant; each draw is O(1). theta must be in (0, 1).
+class ZipfianGenerator {
+public:
+    explicit ZipfianGenerator(uint64_t items, double theta = 0.99) : items(items), theta(theta) {
+        if (!(theta > 0.0 && theta < 1.0)) throw std::invalid_argument("Zipfian theta must be in (0, 1)");
+        zeta_n = zeta(items, theta);
+        double zeta_2 = zeta(2, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / static_cast<double>(items), 1.0 - theta)) / (1.0 - zeta_2 / zeta_n);
+    }
+
+    template <typename Rng>
+    uint64_t operator()(Rng& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zeta_n;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta)) return 1;
+        uint64_t rank = static_cast<uint64_t>(static_cast<double>(items) * std::pow(eta * u - eta + 1.0, alpha));
+        return rank < items ? rank : items - 1;
+    }
+
+private:
+    static double zeta(uint64_t n, double theta) {
+        double sum = 0.0;
+        for (uint64_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    uint64_t items;
+    double theta;
+    double zeta_n;
+    double alpha;
+    double eta;
+};
+
+// spreads ranks over the key space so popular keys are not also numerically adjacent
+inline int scatter_rank(uint64_t rank) {
+    return static_cast<int>(static_cast<uint32_t>(rank * 0x9e3779b1u));
+}
+
+#endif
@@ -0,0 +1,646 @@
+#include "cuckoo_hash.hpp"
+#include "rand_cuckoo_hash.hpp"
+#include "huge_page_resource.hpp"
+#include "read_mostly_cuckoo_hash.hpp"
+#include "hash_join.hpp"
+#include "group_by.hpp"
+#include "cuckoo_set_ops.hpp"
+#include "cuckoo_cache.hpp"
+#include "local_cuckoo_hash.hpp"
+#include "string_cuckoo_hash.hpp"
+#include "key_distributions.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <vector>
+
+// Each benchmark prints one line per configuration so runs can be diffed or grepped.
+// Usage: CuckooBench [benchmark name|all] [scale]
+// scale multiplies the default problem sizes, e.g. 0.1 for a quick smoke run.
+
+namespace {
+    using bench_clock = std::chrono::steady_clock;
+
+    double scale = 1.0;
+
+    size_t scaled(size_t n) {
+        return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(n) * scale));
+    }
+
+    double seconds_since(bench_clock::time_point start) {
+        return std::chrono::duration<double>(bench_clock::now() - start).count();
+    }
+
+    std::vector<int> random_keys(size_t n, uint64_t seed) {
+        std::mt19937_64 gen(seed);
+        std::uniform_int_distribution<int> dist(INT32_MIN, INT32_MAX);
+        std::vector<int> keys(n);
+        for (int& k : keys) k = dist(gen);
+        return keys;
+    }
+
+    // keeps lookup results alive so the loops cannot be optimised away
+    volatile size_t sink;
+
+    // <-----------------------------------------------------------------HUGE PAGES-------------------------------------------------------------->
+
+    void lookup_latency(const char* label, std::pmr::memory_resource* resource, const std::vector<int>& keys,
+                        const std::vector<int>& probes) {
+        // start at the largest rung so no rehash happens while loading
+        RandCuckooHash table(18, 1388210758, true, resource);
+
+        auto start = bench_clock::now();
+        for (int k : keys) table.insert(k);
+        double load_s = seconds_since(start);
+
+        size_t found = 0;
+        start = bench_clock::now();
+        for (int k : probes) found += table.contains(k) != -1;
+        double lookup_s = seconds_since(start);
+        sink = found;
+
+        std::cout << "huge_pages resource=" << label
+                  << " slots=" << table.capacity()
+                  << " keys=" << table.size()
+                  << " rehashes=" << table.times_rehashed()
+                  << " insert_ns=" << load_s * 1e9 / static_cast<double>(keys.size())
+                  << " lookup_ns=" << lookup_s * 1e9 / static_cast<double>(probes.size())
+                  << std::endl;
+    }
+
+    void bench_huge_pages() {
+        std::vector<int> keys = random_keys(scaled(8'000'000), 1);
+
+        // half hits, half misses, in random order
+        std::vector<int> probes = random_keys(scaled(10'000'000), 2);
+        std::mt19937_64 gen(3);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[gen() % keys.size()];
+
+        lookup_latency("default", std::pmr::get_default_resource(), keys, probes);
+
+        HugePageResource huge_pages;
+        lookup_latency("huge_pages", &huge_pages, keys, probes);
+
+        HugePageResource prefaulted(HugePageResource::huge_page_size / 2, true);
+        lookup_latency("huge_pages_prefault", &prefaulted, keys, probes);
+    }
+
+    // <-----------------------------------------------------------------READ-MOSTLY-------------------------------------------------------------->
+
+    void bench_read_mostly() {
+        std::vector<int> keys = random_keys(scaled(1'000'000), 1);
+        std::vector<int> probes = random_keys(1 << 20, 2);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[i % keys.size()];
+
+        auto initial = std::make_unique<RandCuckooHash>(0, 1388210758, true);
+        for (int k : keys) initial->insert(k);
+        ReadMostlyCuckooHash<RandCuckooHash> set(std::move(initial));
+
+        const auto run_for = std::chrono::duration<double>(2.0 * scale);
+        const auto republish_every = std::chrono::milliseconds(50);
+        unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            std::atomic<bool> done{false};
+            std::atomic<size_t> lookups{0};
+            size_t republishes = 0;
+
+            std::vector<std::thread> readers;
+            for (unsigned t = 0; t < threads; ++t) {
+                readers.emplace_back([&, t] {
+                    auto reader = set.reader();
+                    size_t local = 0, found = 0, i = t * 4096;
+                    while (!done.load(std::memory_order_relaxed)) {
+                        for (int batch = 0; batch < 1024; ++batch, ++local) {
+                            found += reader.contains(probes[i++ & (probes.size() - 1)]) != -1;
+                        }
+                    }
+                    lookups += local;
+                    sink = found;
+                });
+            }
+
+            // writer keeps copying and republishing the set while readers run
+            auto start = bench_clock::now();
+            int next_key = 0;
+            while (bench_clock::now() - start < run_for) {
+                set.update([&](RandCuckooHash& table) { table.insert(next_key++); });
+                ++republishes;
+                std::this_thread::sleep_for(republish_every);
+            }
+            done = true;
+            for (auto& t : readers) t.join();
+            double elapsed = seconds_since(start);
+
+            std::cout << "read_mostly readers=" << threads
+                      << " keys=" << keys.size()
+                      << " republishes=" << republishes
+                      << " mlookups_per_s=" << static_cast<double>(lookups.load()) / elapsed / 1e6
+                      << " retired_pending=" << set.reclaim()
+                      << std::endl;
+
+            if (threads == max_threads) break;
+            if (threads * 2 > max_threads) threads = max_threads / 2;
+        }
+    }
+
+    // <-----------------------------------------------------------------FROZEN-------------------------------------------------------------->
+
+    void bench_frozen() {
+        for (size_t n : {scaled(100'000), scaled(1'000'000), scaled(8'000'000)}) {
+            std::vector<int> keys = random_keys(n, 1);
+            std::vector<int> probes = random_keys(scaled(10'000'000), 2);
+            for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+
+            RandCuckooHash table(0, 1388210758, true);
+            for (int k : keys) table.insert(k);
+
+            auto start = bench_clock::now();
+            FrozenCuckooHash frozen = table.freeze();
+            double freeze_s = seconds_since(start);
+
+            size_t found = 0;
+            start = bench_clock::now();
+            for (int k : probes) found += table.contains(k) != -1;
+            double mutable_s = seconds_since(start);
+
+            start = bench_clock::now();
+            for (int k : probes) found += frozen.contains(k) != -1;
+            double frozen_s = seconds_since(start);
+            sink = found;
+
+            double per_probe = 1e9 / static_cast<double>(probes.size());
+            std::cout << "frozen keys=" << table.size()
+                      << " mutable_bytes=" << table.capacity() * sizeof(std::optional<int>)
+                      << " frozen_bytes=" << frozen.memory_bytes()
+                      << " frozen_load=" << frozen.load_factor()
+                      << " seed_attempts=" << frozen.seed_attempts()
+                      << " freeze_ms=" << freeze_s * 1e3
+                      << " mutable_lookup_ns=" << mutable_s * per_probe
+                      << " frozen_lookup_ns=" << frozen_s * per_probe
+                      << std::endl;
+        }
+    }
+
+    // <-----------------------------------------------------------------HASH JOIN-------------------------------------------------------------->
+
+    void bench_hash_join() {
+        size_t rows = scaled(10'000'000);
+        std::mt19937_64 gen(1);
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(rows) - 1);
+        std::vector<int> build(rows), probe(rows);
+        for (int& k : build) k = dist(gen);
+        for (int& k : probe) k = dist(gen);
+
+        // std::unordered_map baseline: key -> build row ids
+        auto start = bench_clock::now();
+        std::unordered_map<int, std::vector<uint32_t>> map;
+        for (uint32_t r = 0; r < build.size(); ++r) map[build[r]].push_back(r);
+        double map_build_s = seconds_since(start);
+
+        start = bench_clock::now();
+        std::vector<uint32_t> out_build, out_probe;
+        for (uint32_t r = 0; r < probe.size(); ++r) {
+            auto it = map.find(probe[r]);
+            if (it == map.end()) continue;
+            for (uint32_t b : it->second) {
+                out_build.push_back(b);
+                out_probe.push_back(r);
+            }
+        }
+        double map_probe_s = seconds_since(start);
+        std::cout << "hash_join impl=unordered_map rows=" << rows << "x" << rows
+                  << " matches=" << out_build.size()
+                  << " build_ms=" << map_build_s * 1e3
+                  << " probe_ms=" << map_probe_s * 1e3 << std::endl;
+        map.clear();
+
+        start = bench_clock::now();
+        HashJoin join(build);
+        double build_s = seconds_since(start);
+
+        unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            start = bench_clock::now();
+            auto partitions = join.join(probe, threads);
+            double probe_s = seconds_since(start);
+
+            size_t matches = 0;
+            for (const auto& partition : partitions) matches += partition.build_rows.size();
+            std::cout << "hash_join impl=cuckoo threads=" << threads << " rows=" << rows << "x" << rows
+                      << " matches=" << matches
+                      << " build_ms=" << build_s * 1e3
+                      << " probe_ms=" << probe_s * 1e3 << std::endl;
+        }
+    }
+
+    // <-----------------------------------------------------------------GROUP BY-------------------------------------------------------------->
+
+    void group_by_run(const char* distribution, const std::vector<int>& keys, const std::vector<int64_t>& values) {
+        auto start = bench_clock::now();
+        std::unordered_map<int, Accumulator> map;
+        for (size_t i = 0; i < keys.size(); ++i) map[keys[i]].add(values[i]);
+        double map_s = seconds_since(start);
+        std::cout << "group_by dist=" << distribution << " impl=unordered_map threads=1"
+                  << " rows=" << keys.size() << " groups=" << map.size()
+                  << " mrows_per_s=" << static_cast<double>(keys.size()) / map_s / 1e6 << std::endl;
+
+        unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            GroupBy group_by(threads);
+            start = bench_clock::now();
+            group_by.run(keys, values);
+            double cuckoo_s = seconds_since(start);
+            std::cout << "group_by dist=" << distribution << " impl=cuckoo threads=" << threads
+                      << " rows=" << keys.size() << " groups=" << group_by.size()
+                      << " mrows_per_s=" << static_cast<double>(keys.size()) / cuckoo_s / 1e6 << std::endl;
+        }
+    }
+
+    void bench_group_by() {
+        size_t rows = scaled(20'000'000);
+        uint64_t groups = scaled(1'000'000);
+        std::mt19937_64 gen(1);
+        std::vector<int> keys(rows);
+        std::vector<int64_t> values(rows);
+        for (int64_t& v : values) v = static_cast<int64_t>(gen() % 1'000);
+
+        std::uniform_int_distribution<uint64_t> uniform(0, groups - 1);
+        for (int& k : keys) k = scatter_rank(uniform(gen));
+        group_by_run("uniform", keys, values);
+
+        ZipfianGenerator zipf(groups);
+        for (int& k : keys) k = scatter_rank(zipf(gen));
+        group_by_run("zipf_0.99", keys, values);
+    }
+
+    // <-----------------------------------------------------------------BULK OPERATIONS-------------------------------------------------------------->
+
+    // what callers wrote before iterators existed: walk both raw slot arrays
+    template <typename Fn>
+    void scan_buckets(const RandCuckooHash& table, Fn&& fn) {
+        for (const auto& slot : table.h1_bucket()) if (slot) fn(*slot);
+        for (const auto& slot : table.h2_bucket()) if (slot) fn(*slot);
+    }
+
+    void bench_bulk_ops() {
+        for (size_t n : {scaled(100'000), scaled(2'000'000)}) {
+            std::vector<int> keys = random_keys(n, 1);
+            RandCuckooHash large(0, 1388210758, true), small(0, 42, true);
+            for (int k : keys) large.insert(k);
+            // a tenth the size, half of it shared with large
+            std::vector<int> other = random_keys(n / 10, 2);
+            for (size_t i = 0; i < other.size(); i += 2) other[i] = keys[(i * 7919) % keys.size()];
+            for (int k : other) small.insert(k);
+
+            int64_t sum = 0;
+            auto start = bench_clock::now();
+            scan_buckets(large, [&](int k) { sum += k; });
+            double scan_loop_s = seconds_since(start);
+            start = bench_clock::now();
+            for (int k : large) sum += k;
+            double scan_iter_s = seconds_since(start);
+
+            RandCuckooHash copy_loop(large), copy_bulk(large);
+            start = bench_clock::now();
+            std::vector<int> doomed;
+            scan_buckets(copy_loop, [&](int k) { if (k % 4 == 0) doomed.push_back(k); });
+            for (int k : doomed) copy_loop.erase(k);
+            double erase_loop_s = seconds_since(start);
+            start = bench_clock::now();
+            size_t erased = copy_bulk.erase_if([](int k) { return k % 4 == 0; });
+            double erase_bulk_s = seconds_since(start);
+
+            // intersection by probing large with contains for every key of small
+            start = bench_clock::now();
+            RandCuckooHash common_loop(0, 7, true);
+            scan_buckets(small, [&](int k) { if (large.contains(k) != -1) common_loop.insert(k); });
+            double intersect_loop_s = seconds_since(start);
+            start = bench_clock::now();
+            RandCuckooHash common_bulk = table_intersection(large, small);
+            double intersect_bulk_s = seconds_since(start);
+
+            start = bench_clock::now();
+            RandCuckooHash union_loop(large);
+            scan_buckets(small, [&](int k) { if (union_loop.contains(k) == -1) union_loop.insert(k); });
+            double union_loop_s = seconds_since(start);
+            start = bench_clock::now();
+            RandCuckooHash union_bulk = table_union(large, small);
+            double union_bulk_s = seconds_since(start);
+
+            start = bench_clock::now();
+            RandCuckooHash diff_loop(large);
+            scan_buckets(small, [&](int k) { if (diff_loop.contains(k) != -1) diff_loop.erase(k); });
+            double diff_loop_s = seconds_since(start);
+            start = bench_clock::now();
+            RandCuckooHash diff_bulk = table_difference(large, small);
+            double diff_bulk_s = seconds_since(start);
+
+            sink = static_cast<size_t>(sum) + erased + common_loop.size() + common_bulk.size()
+                 + union_loop.size() + union_bulk.size() + diff_loop.size() + diff_bulk.size();
+
+            std::cout << "bulk_ops keys=" << large.size() << " other=" << small.size()
+                      << " slots=" << large.capacity()
+                      << " scan_loop_ms=" << scan_loop_s * 1e3 << " scan_iter_ms=" << scan_iter_s * 1e3
+                      << " erase_loop_ms=" << erase_loop_s * 1e3 << " erase_if_ms=" << erase_bulk_s * 1e3
+                      << " intersect_loop_ms=" << intersect_loop_s * 1e3 << " intersect_ms=" << intersect_bulk_s * 1e3
+                      << " union_loop_ms=" << union_loop_s * 1e3 << " union_ms=" << union_bulk_s * 1e3
+                      << " diff_loop_ms=" << diff_loop_s * 1e3 << " diff_ms=" << diff_bulk_s * 1e3
+                      << std::endl;
+        }
+    }
+
+    // <-----------------------------------------------------------------CACHE-------------------------------------------------------------->
+
+    // reference point for the hit ratio: exact LRU on a linked list and unordered_map
+    class LruCache {
+    public:
+        explicit LruCache(size_t capacity) : capacity(capacity) { index.reserve(capacity); }
+
+        std::optional<int> find(int key) {
+            auto it = index.find(key);
+            if (it == index.end()) return std::nullopt;
+            order.splice(order.begin(), order, it->second);
+            return it->second->second;
+        }
+
+        void insert(int key, int value) {
+            if (index.size() == capacity) {
+                index.erase(order.back().first);
+                order.pop_back();
+            }
+            order.emplace_front(key, value);
+            index[key] = order.begin();
+        }
+
+    private:
+        size_t capacity;
+        std::list<std::pair<int, int>> order;
+        std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+    };
+
+    // cache-aside: look the key up and insert it on a miss
+    template <typename Cache>
+    void cache_run(const char* label, Cache& cache, size_t slots, const std::vector<int>& requests) {
+        size_t hits = 0;
+        auto start = bench_clock::now();
+        for (int key : requests) {
+            if (cache.find(key)) ++hits;
+            else cache.insert(key, key);
+        }
+        double run_s = seconds_since(start);
+        sink = hits;
+
+        std::cout << "cache impl=" << label
+                  << " slots=" << slots
+                  << " requests=" << requests.size()
+                  << " hit_ratio=" << static_cast<double>(hits) / static_cast<double>(requests.size())
+                  << " mops=" << static_cast<double>(requests.size()) / run_s / 1e6
+                  << std::endl;
+    }
+
+    void bench_cache() {
+        size_t items = scaled(10'000'000);
+        ZipfianGenerator zipf(items);
+        std::mt19937_64 gen(1);
+        std::vector<int> requests(scaled(20'000'000));
+        for (int& k : requests) k = scatter_rank(zipf(gen));
+
+        // roughly 1% and 7% of the key space
+        for (int size_index : {11, 14}) {
+            CuckooCache<int> cuckoo(size_index, 1);
+            cache_run("cuckoo_clock", cuckoo, cuckoo.capacity(), requests);
+            std::cout << "cache impl=cuckoo_clock evictions=" << cuckoo.evictions()
+                      << " load=" << cuckoo.load_factor() << std::endl;
+
+            LruCache lru(cuckoo.capacity());
+            cache_run("lru_list", lru, cuckoo.capacity(), requests);
+        }
+    }
+
+    // <-----------------------------------------------------------------LOCALITY-------------------------------------------------------------->
+
+    // two-array RandCuckooHash with the load limit lifted and a long chain budget, so only a failed chain stops it
+    struct UnboundedRandCuckooHash : RandCuckooHash {
+        UnboundedRandCuckooHash(int size_index, int32_t seed) : RandCuckooHash(size_index, seed, true) {
+            max_load = 1.0f;
+            max_steps = 500;
+        }
+    };
+
+    // inserts random keys until the first failed eviction chain, returns the load just before it
+    template <typename Table>
+    float achievable_load(Table& table, uint64_t seed, bool (*failed)(const Table&)) {
+        std::mt19937_64 gen(seed);
+        float load = 0.0f;
+        while (true) {
+            load = table.load_factor();
+            table.insert(static_cast<int>(gen()));
+            if (failed(table)) return load;
+        }
+    }
+
+    void bench_locality() {
+        for (int size_index : {12, 18}) {
+            for (float fill : {0.3f, 0.45f}) {
+                UnboundedRandCuckooHash two_array(size_index, 1388210758);
+                LocalCuckooHash local(size_index, 1, 1.0f);
+                size_t n = static_cast<size_t>(fill * static_cast<float>(two_array.capacity()));
+                std::vector<int> keys = random_keys(n, 1);
+                std::vector<int> probes = random_keys(n, 2);
+                for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+
+                auto start = bench_clock::now();
+                for (int k : keys) two_array.insert(k);
+                double two_insert_s = seconds_since(start);
+                start = bench_clock::now();
+                for (int k : keys) local.insert(k);
+                double local_insert_s = seconds_since(start);
+
+                size_t found = 0;
+                start = bench_clock::now();
+                for (int k : probes) found += two_array.contains(k) != -1;
+                double two_lookup_s = seconds_since(start);
+                start = bench_clock::now();
+                for (int k : probes) found += local.contains(k) != -1;
+                double local_lookup_s = seconds_since(start);
+                sink = found;
+
+                double per_key = 1e9 / static_cast<double>(n);
+                std::cout << "locality slots=" << two_array.capacity() << "/" << local.capacity()
+                          << " fill=" << fill
+                          << " two_array_insert_ns=" << two_insert_s * per_key
+                          << " local_insert_ns=" << local_insert_s * per_key
+                          << " two_array_lookup_ns=" << two_lookup_s * per_key
+                          << " local_lookup_ns=" << local_lookup_s * per_key
+                          << " two_array_rebuilds=" << two_array.times_rehashed() + two_array.times_reseeded()
+                          << " local_rebuilds=" << local.times_rehashed()
+                          << std::endl;
+            }
+        }
+
+        for (uint64_t seed = 1; seed <= 3; ++seed) {
+            UnboundedRandCuckooHash two_array(16, static_cast<int32_t>(seed));
+            LocalCuckooHash local(16, seed, 1.0f);
+            float two_load = achievable_load<UnboundedRandCuckooHash>(two_array, seed, [](const UnboundedRandCuckooHash& t) {
+                return t.times_rehashed() + t.times_reseeded() > 0;
+            });
+            float local_load = achievable_load<LocalCuckooHash>(local, seed, [](const LocalCuckooHash& t) {
+                return t.times_rehashed() > 0;
+            });
+            std::cout << "locality achievable_load seed=" << seed << " slots=" << two_array.capacity()
+                      << " two_array=" << two_load << " local=" << local_load << std::endl;
+        }
+    }
+
+    // <-----------------------------------------------------------------STRING KEYS-------------------------------------------------------------->
+
+    // transparent hash so the baseline can also be probed with string_view and no temporary string
+    struct StringViewHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    void bench_strings() {
+        size_t n = scaled(2'000'000);
+        std::mt19937_64 gen(11);
+        std::uniform_int_distribution<int> length(8, 40);
+        auto random_string = [&]() {
+            std::string s(static_cast<size_t>(length(gen)), ' ');
+            for (char& c : s) c = static_cast<char>('a' + gen() % 26);
+            return s;
+        };
+        std::vector<std::string> keys(n);
+        for (std::string& k : keys) k = random_string();
+        // half hits, half misses, all views into one buffer so probing allocates nothing
+        std::string probe_bytes;
+        std::vector<std::pair<size_t, size_t>> probe_spans;
+        for (size_t i = 0; i < n; ++i) {
+            std::string p = i % 2 == 0 ? keys[(i * 7919) % n] : random_string();
+            probe_spans.emplace_back(probe_bytes.size(), p.size());
+            probe_bytes += p;
+        }
+        std::vector<std::string_view> probes;
+        for (auto [offset, size] : probe_spans) probes.emplace_back(probe_bytes.data() + offset, size);
+
+        StringCuckooHash table(0, 1);
+        std::unordered_set<std::string, StringViewHash, std::equal_to<>> baseline;
+
+        auto start = bench_clock::now();
+        for (const std::string& k : keys) table.insert(k);
+        double table_insert_s = seconds_since(start);
+        start = bench_clock::now();
+        for (const std::string& k : keys) baseline.insert(k);
+        double baseline_insert_s = seconds_since(start);
+
+        size_t found = 0;
+        start = bench_clock::now();
+        for (std::string_view p : probes) found += table.contains(p) != -1;
+        double table_lookup_s = seconds_since(start);
+        start = bench_clock::now();
+        for (std::string_view p : probes) found += baseline.find(p) != baseline.end();
+        double baseline_lookup_s = seconds_since(start);
+        sink = found;
+
+        double per_key = 1e9 / static_cast<double>(n);
+        std::cout << "strings keys=" << n
+                  << " cuckoo_insert_ns=" << table_insert_s * per_key
+                  << " unordered_set_insert_ns=" << baseline_insert_s * per_key
+                  << " cuckoo_lookup_ns=" << table_lookup_s * per_key
+                  << " unordered_set_lookup_ns=" << baseline_lookup_s * per_key
+                  << " cuckoo_load=" << table.load_factor()
+                  << " arena_bytes=" << table.arena_bytes()
+                  << std::endl;
+    }
+
+    // <-----------------------------------------------------------------TRY INSERT-------------------------------------------------------------->
+
+    void bench_try_insert() {
+        size_t n = scaled(2'000'000);
+        std::vector<int> keys = random_keys(n, 5);
+        auto nanos = [](bench_clock::time_point start) {
+            return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+        };
+
+        // worst single call: insert pays for every rebuild inline, try_insert never does
+        RandCuckooHash inline_table(0, 1388210758, true);
+        double insert_worst = 0;
+        auto total = bench_clock::now();
+        for (int k : keys) {
+            auto start = bench_clock::now();
+            inline_table.insert(k);
+            insert_worst = std::max(insert_worst, nanos(start));
+        }
+        double insert_total_s = seconds_since(total);
+
+        RandCuckooHash scheduled_table(0, 1388210758, true);
+        double try_worst = 0, grow_worst = 0;
+        total = bench_clock::now();
+        for (int k : keys) {
+            while (true) {
+                auto start = bench_clock::now();
+                RandCuckooHash::insert_result result = scheduled_table.try_insert(k);
+                try_worst = std::max(try_worst, nanos(start));
+                if (result != RandCuckooHash::insert_result::needs_growth) break;
+                // stands in for growth scheduled off the latency-critical path
+                start = bench_clock::now();
+                scheduled_table.grow();
+                grow_worst = std::max(grow_worst, nanos(start));
+            }
+        }
+        double try_total_s = seconds_since(total);
+
+        std::cout << "try_insert keys=" << n
+                  << " insert_worst_us=" << insert_worst / 1000
+                  << " try_insert_worst_us=" << try_worst / 1000
+                  << " grow_worst_us=" << grow_worst / 1000
+                  << " insert_total_s=" << insert_total_s
+                  << " try_insert_total_s=" << try_total_s
+                  << " rebuilds=" << inline_table.times_rehashed() + inline_table.times_reseeded()
+                  << "/" << scheduled_table.times_rehashed()
+                  << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::map<std::string, std::function<void()>> benchmarks{
+        {"huge_pages", bench_huge_pages},
+        {"read_mostly", bench_read_mostly},
+        {"frozen", bench_frozen},
+        {"hash_join", bench_hash_join},
+        {"group_by", bench_group_by},
+        {"bulk_ops", bench_bulk_ops},
+        {"cache", bench_cache},
+        {"locality", bench_locality},
+        {"strings", bench_strings},
+        {"try_insert", bench_try_insert},
+    };
+
+    std::string name = argc > 1 ? argv[1] : "all";
+    if (argc > 2) scale = std::atof(argv[2]);
+
+    if (name == "all") {
+        for (const auto& [bench_name, run] : benchmarks) run();
+        return 0;
+    }
+
+    auto it = benchmarks.find(name);
+    if (it == benchmarks.end()) {
+        std::cerr << "unknown benchmark " << name << ", available:";
+        for (const auto& [bench_name, run] : benchmarks) std::cerr << " " << bench_name;
+        std::cerr << std::endl;
+        return 1;
+    }
+    it->second();
+    return 0;
+}
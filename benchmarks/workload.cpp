@@ -0,0 +1,350 @@
+#include "cuckoo_hash.hpp"
+#include "rand_cuckoo_hash.hpp"
+#include "keyed_cuckoo_hash.hpp"
+#include "hash_mix.hpp"
+#include "key_distributions.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CUCKOO_HAVE_MMAP 1
+#endif
+
+// YCSB-style workload driver: loads records, then runs a mix of insert/find/erase operations against
+// one table and samples throughput, memory, rehash count and load factor every --interval operations.
+//
+//     CuckooWorkload --table=rand --records=1000000 --operations=10000000
+//                    --insert=0.05 --find=0.9 --erase=0.05 --distribution=zipfian --format=csv
+//
+// Inserted keys are record numbers 0, 1, 2... scattered over the key space, so every insert is a new
+// key. find and erase pick a record number from the distribution:
+//   uniform  every record so far equally likely
+//   zipfian  record 0 hottest, popularity falling off with --theta
+//   latest   the newest records hottest, Zipfian by age
+//
+// --trace replays a binary file of raw native-endian keys (int32 or int64 to match --key-bits), mapped
+// with mmap: operation i uses key i of the trace, the operation type still comes from the mix.
+// --write-trace saves the generated key sequence in the same format so a run can be replayed.
+
+namespace {
+    using bench_clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string table = "rand";
+        int key_bits = 32;
+        uint64_t records = 100'000;
+        uint64_t operations = 1'000'000;
+        double insert = 0.05;
+        double find = 0.9;
+        double erase = 0.05;
+        std::string distribution = "zipfian";
+        double theta = 0.99;
+        uint64_t interval = 100'000;
+        uint64_t seed = 1;
+        std::string format = "csv";
+        std::string trace;
+        std::string write_trace;
+    };
+
+    void usage() {
+        std::cerr << "usage: CuckooWorkload [--option=value]...\n"
+                     "  --table=cuckoo|rand|keyed    hash family: fixed, Carter-Wegman or SipHash (rand)\n"
+                     "  --key-bits=32|64             key width (32)\n"
+                     "  --records=N                  keys loaded before the run (100000)\n"
+                     "  --operations=N               operations in the run (1000000)\n"
+                     "  --insert=P --find=P --erase=P   operation mix, normalised to sum to 1 (0.05/0.9/0.05)\n"
+                     "  --distribution=uniform|zipfian|latest   key choice for find/erase (zipfian)\n"
+                     "  --theta=T                    Zipfian skew, 0 < T < 1 (0.99)\n"
+                     "  --interval=N                 operations per sample (100000)\n"
+                     "  --seed=N                     seed for the mix, the keys and the hash parameters (1)\n"
+                     "  --format=csv|json            output format (csv)\n"
+                     "  --trace=FILE                 replay keys from a binary trace\n"
+                     "  --write-trace=FILE           save the generated keys as a binary trace\n";
+    }
+
+    Options parse(int argc, char* argv[]) {
+        Options options;
+        std::map<std::string, std::string> values;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            size_t equals = arg.find('=');
+            if (arg.rfind("--", 0) != 0 || equals == std::string::npos) throw std::invalid_argument("bad argument " + arg);
+            values[arg.substr(2, equals - 2)] = arg.substr(equals + 1);
+        }
+
+        for (const auto& [name, value] : values) {
+            if (name == "table") options.table = value;
+            else if (name == "key-bits") options.key_bits = std::stoi(value);
+            else if (name == "records") options.records = std::stoull(value);
+            else if (name == "operations") options.operations = std::stoull(value);
+            else if (name == "insert") options.insert = std::stod(value);
+            else if (name == "find") options.find = std::stod(value);
+            else if (name == "erase") options.erase = std::stod(value);
+            else if (name == "distribution") options.distribution = value;
+            else if (name == "theta") options.theta = std::stod(value);
+            else if (name == "interval") options.interval = std::max<uint64_t>(1, std::stoull(value));
+            else if (name == "seed") options.seed = std::stoull(value);
+            else if (name == "format") options.format = value;
+            else if (name == "trace") options.trace = value;
+            else if (name == "write-trace") options.write_trace = value;
+            else throw std::invalid_argument("unknown option --" + name);
+        }
+
+        if (options.table != "cuckoo" && options.table != "rand" && options.table != "keyed") throw std::invalid_argument("unknown table " + options.table);
+        if (options.key_bits != 32 && options.key_bits != 64) throw std::invalid_argument("--key-bits must be 32 or 64");
+        if (options.distribution != "uniform" && options.distribution != "zipfian" && options.distribution != "latest") {
+            throw std::invalid_argument("unknown distribution " + options.distribution);
+        }
+        // the Zipfian constants divide by 1 - theta and assume a positive skew
+        if (!(options.theta > 0.0 && options.theta < 1.0)) throw std::invalid_argument("--theta must be between 0 and 1 exclusive");
+        if (options.format != "csv" && options.format != "json") throw std::invalid_argument("unknown format " + options.format);
+        if (options.insert < 0 || options.find < 0 || options.erase < 0 || options.insert + options.find + options.erase <= 0) {
+            throw std::invalid_argument("operation mix must be non-negative and not all zero");
+        }
+        return options;
+    }
+
+    // Read-only mapping of a trace file, falls back to reading it into memory without mmap
+    template <typename Key>
+    class Trace {
+    public:
+        explicit Trace(const std::string& path) {
+#ifdef CUCKOO_HAVE_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) throw std::runtime_error("cannot open trace " + path);
+            struct stat st{};
+            if (fstat(fd, &st) == -1) {
+                ::close(fd);
+                throw std::runtime_error("cannot stat trace " + path);
+            }
+            bytes = static_cast<size_t>(st.st_size);
+            if (bytes > 0) {
+                void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mapped == MAP_FAILED) throw std::runtime_error("cannot map trace " + path);
+                madvise(mapped, bytes, MADV_SEQUENTIAL);
+                mapping = mapped;
+                keys = static_cast<const Key*>(mapped);
+            } else {
+                ::close(fd);
+            }
+#else
+            std::ifstream in(path, std::ios::binary);
+            if (!in) throw std::runtime_error("cannot open trace " + path);
+            std::vector<char> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            bytes = raw.size();
+            copy.resize(bytes / sizeof(Key));
+            std::memcpy(copy.data(), raw.data(), copy.size() * sizeof(Key));
+            keys = copy.data();
+#endif
+            count = bytes / sizeof(Key);
+        }
+
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+
+        ~Trace() {
+#ifdef CUCKOO_HAVE_MMAP
+            if (mapping) munmap(mapping, bytes);
+#endif
+        }
+
+        size_t size() const { return count; }
+        Key operator[](size_t i) const { return keys[i]; }
+
+    private:
+        const Key* keys{nullptr};
+        size_t count{0};
+        size_t bytes{0};
+        void* mapping{nullptr};
+        std::vector<Key> copy;
+    };
+
+    // record number -> key, spread over the key space so popular records are not adjacent
+    template <typename Key>
+    Key key_of(uint64_t record) {
+        if constexpr (sizeof(Key) > sizeof(int)) return static_cast<Key>(mix64(record + 1));
+        else return scatter_rank(record);
+    }
+
+    size_t resident_bytes() {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        statm >> pages >> resident;
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    template <typename Key>
+    std::unique_ptr<BasicCuckooHash<Key>> make_table(const Options& options) {
+        if (options.table == "cuckoo") return std::make_unique<BasicCuckooHash<Key>>();
+        if (options.table == "keyed") return std::make_unique<BasicKeyedCuckooHash<Key>>(0, options.seed);
+        return std::make_unique<BasicRandCuckooHash<Key>>(0, static_cast<int32_t>(options.seed), true);
+    }
+
+    struct Sample {
+        uint64_t operations;
+        double elapsed_s;
+        double ops_per_s;
+        uint64_t inserts, finds, found, erases;
+        size_t size, capacity;
+        float load_factor;
+        int rehashes, reseeds;
+        size_t table_bytes, resident_bytes;
+    };
+
+    void print_header(const Options& options) {
+        if (options.format == "csv") {
+            std::cout << "operations,elapsed_s,ops_per_s,inserts,finds,found,erases,size,capacity,"
+                         "load_factor,rehashes,reseeds,table_bytes,resident_bytes\n";
+        } else {
+            std::cout << "{\n  \"config\": {\"table\": \"" << options.table << "\", \"key_bits\": " << options.key_bits
+                      << ", \"records\": " << options.records << ", \"operations\": " << options.operations
+                      << ", \"insert\": " << options.insert << ", \"find\": " << options.find << ", \"erase\": " << options.erase
+                      << ", \"distribution\": \"" << options.distribution << "\", \"theta\": " << options.theta
+                      << ", \"seed\": " << options.seed << ", \"trace\": \"" << options.trace << "\"},\n  \"samples\": [";
+        }
+    }
+
+    void print_sample(const Options& options, const Sample& s, bool first) {
+        if (options.format == "csv") {
+            std::cout << s.operations << ',' << s.elapsed_s << ',' << s.ops_per_s << ',' << s.inserts << ',' << s.finds << ','
+                      << s.found << ',' << s.erases << ',' << s.size << ',' << s.capacity << ',' << s.load_factor << ','
+                      << s.rehashes << ',' << s.reseeds << ',' << s.table_bytes << ',' << s.resident_bytes << '\n';
+        } else {
+            std::cout << (first ? "\n" : ",\n")
+                      << "    {\"operations\": " << s.operations << ", \"elapsed_s\": " << s.elapsed_s << ", \"ops_per_s\": " << s.ops_per_s
+                      << ", \"inserts\": " << s.inserts << ", \"finds\": " << s.finds << ", \"found\": " << s.found
+                      << ", \"erases\": " << s.erases << ", \"size\": " << s.size << ", \"capacity\": " << s.capacity
+                      << ", \"load_factor\": " << s.load_factor << ", \"rehashes\": " << s.rehashes << ", \"reseeds\": " << s.reseeds
+                      << ", \"table_bytes\": " << s.table_bytes << ", \"resident_bytes\": " << s.resident_bytes << "}";
+        }
+    }
+
+    template <typename Key>
+    void run(const Options& options) {
+        std::unique_ptr<Trace<Key>> trace;
+        if (!options.trace.empty()) trace = std::make_unique<Trace<Key>>(options.trace);
+        uint64_t operations = trace ? std::min<uint64_t>(options.operations, trace->size()) : options.operations;
+
+        std::mt19937_64 gen(options.seed);
+        std::unique_ptr<BasicCuckooHash<Key>> table = make_table<Key>(options);
+        for (uint64_t record = 0; record < options.records; ++record) table->insert(key_of<Key>(record));
+        uint64_t next_record = options.records;
+
+        double total = options.insert + options.find + options.erase;
+        double insert_below = options.insert / total;
+        double find_below = insert_below + options.find / total;
+        std::uniform_real_distribution<double> choose(0.0, 1.0);
+
+        // the Zipfian generator covers every record the run can create, draws past the current count wrap
+        ZipfianGenerator zipf(std::max<uint64_t>(1, options.records + operations), options.theta);
+        auto pick_record = [&]() -> uint64_t {
+            uint64_t existing = std::max<uint64_t>(1, next_record);
+            if (options.distribution == "uniform") return std::uniform_int_distribution<uint64_t>(0, existing - 1)(gen);
+            // ranks past the records loaded so far are redrawn, folding them back would skew the low ranks;
+            // rank 0 alone carries a large share of the mass, so the loop ends quickly
+            uint64_t rank = zipf(gen);
+            while (rank >= existing) rank = zipf(gen);
+            return options.distribution == "latest" ? existing - 1 - rank : rank;
+        };
+
+        std::vector<Key> written;
+        if (!options.write_trace.empty()) written.reserve(operations);
+
+        print_header(options);
+        Sample sample{};
+        auto start = bench_clock::now();
+        auto interval_start = start;
+        uint64_t interval_ops = 0;
+        bool first = true;
+
+        for (uint64_t op = 0; op < operations; ++op) {
+            double what = choose(gen);
+            if (what < insert_below) {
+                Key key = trace ? (*trace)[op] : key_of<Key>(next_record);
+                ++next_record;
+                table->insert(key);
+                ++sample.inserts;
+                if (!options.write_trace.empty()) written.push_back(key);
+            } else {
+                Key key = trace ? (*trace)[op] : key_of<Key>(pick_record());
+                if (what < find_below) {
+                    sample.found += table->contains(key) != -1;
+                    ++sample.finds;
+                } else {
+                    table->erase(key);
+                    ++sample.erases;
+                }
+                if (!options.write_trace.empty()) written.push_back(key);
+            }
+
+            if (++interval_ops == options.interval || op + 1 == operations) {
+                auto now = bench_clock::now();
+                sample.operations = op + 1;
+                sample.elapsed_s = std::chrono::duration<double>(now - start).count();
+                sample.ops_per_s = static_cast<double>(interval_ops) / std::chrono::duration<double>(now - interval_start).count();
+                sample.size = table->size();
+                sample.capacity = table->capacity();
+                sample.load_factor = table->load_factor();
+                sample.rehashes = table->times_rehashed();
+                sample.reseeds = table->times_reseeded();
+                // two slot arrays of optional<Key> plus the occupancy bitmap
+                sample.table_bytes = table->capacity() * sizeof(std::optional<Key>) + table->capacity() / 8;
+                sample.resident_bytes = resident_bytes();
+                print_sample(options, sample, first);
+                first = false;
+                interval_start = now;
+                interval_ops = 0;
+            }
+        }
+
+        if (options.format == "json") std::cout << "\n  ]\n}\n";
+        std::cout.flush();
+
+        if (!options.write_trace.empty()) {
+            std::ofstream out(options.write_trace, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(written.data()), static_cast<std::streamsize>(written.size() * sizeof(Key)));
+            if (!out) throw std::runtime_error("cannot write trace " + options.write_trace);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        usage();
+        return 1;
+    }
+
+    try {
+        if (options.key_bits == 64) run<int64_t>(options);
+        else run<int>(options);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+#ifndef CUCKOO_CACHE
+#define CUCKOO_CACHE
+
+#include "cuckoo_hash.hpp"
+#include "hash_mix.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Bounded key -> value cache on a cuckoo table that never grows or rehashes.
+//
+// The capacity is fixed at construction to one rung of CuckooHash's sizes ladder (capacity_for).
+// insert() looks for room along a cuckoo path of at most max_path slots, starting at the key's
+// first bucket; an empty or expired slot on the path ends the search and the entries before it each
+// shift one step to their alternate bucket. When the whole path is live, a victim is chosen along it
+// with CLOCK second-chance bits: each entry read by find() since it was last passed over is spared
+// once, and the first one without its bit set is evicted. Once the cache is nearly full and no entry
+// has a TTL, a walk would almost never find room, so the choice is made between the key's two buckets
+// straight away.
+// Insert is therefore O(max_path) in the worst case, with no rehash and no allocation.
+//
+// Entries may carry a TTL. Expired entries are never returned, and their slots count as free for
+// the next insert that reaches them. size() counts expired entries that nothing has touched yet.
+//
+// Key is int or int64_t like the other tables. Value must be default constructible. Clock is
+// swappable so tests can drive expiry by hand.
+template <typename Key, typename Value, typename Clock = std::chrono::steady_clock>
+class BasicCuckooCache {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using duration = typename Clock::duration;
+    using time_point = typename Clock::time_point;
+
+    // longest cuckoo path searched for a free slot before evicting
+    static constexpr size_t max_path = 8;
+    // above this load, with no TTL entries, eviction skips the walk
+    static constexpr double walk_load = 0.99;
+
+    explicit BasicCuckooCache(int size_index, uint64_t seed = std::random_device{}())
+        : capacity_(BasicCuckooHash<Key>::capacity_for(size_index)), slots(2 * capacity_) {
+        std::mt19937_64 generator(seed);
+        seed_1 = generator();
+        seed_2 = generator();
+    }
+
+    // adds or replaces key, ttl of zero means the entry never expires
+    void insert(Key key, Value value, duration ttl = duration::zero()) {
+        time_point now = Clock::now();
+        time_point expires = ttl == duration::zero() ? time_point::max() : now + ttl;
+
+        if (Slot* slot = locate(key, now)) {
+            expiring_ -= slot->expires != time_point::max();
+            expiring_ += expires != time_point::max();
+            slot->value = std::move(value);
+            slot->expires = expires;
+            return;
+        }
+
+        size_t path[max_path];
+        size_t length = 0;
+        size_t free_at = max_path;
+
+        size_t first = bucket_1(key), second = capacity_ + bucket_2(key);
+        if (reusable(first, now) || reusable(second, now)) {
+            path[length++] = reusable(first, now) ? first : second;
+            free_at = 0;
+        } else if (expiring_ == 0 && static_cast<double>(size_) >= walk_load * static_cast<double>(slots.size())) {
+            // a walk would almost never find room, so CLOCK between the two buckets straight away
+            size_t victim = first;
+            if (slots[first].referenced) {
+                slots[first].referenced = false;
+                if (!slots[second].referenced) victim = second;
+                slots[second].referenced = false;
+            }
+            ++evictions_;
+            assign(slots[victim], key, std::move(value), expires);
+            return;
+        } else {
+            path[length++] = first;
+        }
+
+        while (free_at == max_path && length < max_path) {
+            size_t next = alternate(path[length - 1]);
+            bool cycle = false;
+            for (size_t i = 0; i < length; ++i) cycle |= path[i] == next;
+            if (cycle) break;
+
+            path[length++] = next;
+            if (reusable(next, now)) free_at = length - 1;
+        }
+
+        size_t target = free_at;
+        if (target == max_path) {
+            // no room within reach, run the CLOCK hand along the path
+            target = 0;
+            for (size_t i = 0; i < length; ++i) {
+                if (!slots[path[i]].referenced) {
+                    target = i;
+                    break;
+                }
+                slots[path[i]].referenced = false;
+            }
+            ++evictions_;
+        } else if (slots[path[target]].used) {
+            ++expirations_;
+        }
+
+        // the displaced entry (if any) leaves the cache, the rest shift to their alternate buckets
+        Slot& displaced = slots[path[target]];
+        if (displaced.used) release(displaced);
+        for (size_t i = target; i > 0; --i) slots[path[i]] = std::move(slots[path[i - 1]]);
+        slots[path[0]].used = false;
+        assign(slots[path[0]], key, std::move(value), expires);
+    }
+
+    // value for key if present and not expired, a hit gives the entry a second chance against eviction
+    std::optional<Value> find(Key key) {
+        Slot* slot = locate(key, Clock::now());
+        if (!slot) {
+            ++misses_;
+            return std::nullopt;
+        }
+        ++hits_;
+        slot->referenced = true;
+        return slot->value;
+    }
+
+    bool erase(Key key) {
+        Slot* slot = locate(key, Clock::now());
+        if (!slot) return false;
+        release(*slot);
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots.size(); }
+    float load_factor() const { return static_cast<float>(size_) / static_cast<float>(capacity()); }
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+    uint64_t expirations() const { return expirations_; }
+    double hit_ratio() const {
+        uint64_t lookups = hits_ + misses_;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits_) / static_cast<double>(lookups);
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        time_point expires{};
+        bool used{false};
+        bool referenced{false};
+    };
+
+    // slots[0, capacity_) is the first table, slots[capacity_, 2 * capacity_) the second
+    size_t bucket_1(Key key) const {
+        return static_cast<size_t>(reduce_range(mix64(static_cast<uint64_t>(key) ^ seed_1), capacity_));
+    }
+
+    size_t bucket_2(Key key) const {
+        return static_cast<size_t>(reduce_range(mix64(static_cast<uint64_t>(key) ^ seed_2), capacity_));
+    }
+
+    // the other candidate slot of whatever is stored at index
+    size_t alternate(size_t index) const {
+        Key key = slots[index].key;
+        return index < capacity_ ? capacity_ + bucket_2(key) : bucket_1(key);
+    }
+
+    bool reusable(size_t index, time_point now) const {
+        return !slots[index].used || slots[index].expires <= now;
+    }
+
+    void release(Slot& slot) {
+        expiring_ -= slot.expires != time_point::max();
+        slot.used = false;
+        slot.value = Value{};
+        --size_;
+    }
+
+    // stores a new entry in slot, releasing whatever was there
+    void assign(Slot& slot, Key key, Value value, time_point expires) {
+        if (slot.used) release(slot);
+        slot.key = key;
+        slot.value = std::move(value);
+        slot.expires = expires;
+        slot.used = true;
+        slot.referenced = false;
+        expiring_ += expires != time_point::max();
+        ++size_;
+    }
+
+    // live slot holding key, an expired match is released on the way
+    Slot* locate(Key key, time_point now) {
+        for (size_t index : {bucket_1(key), capacity_ + bucket_2(key)}) {
+            Slot& slot = slots[index];
+            if (!slot.used || slot.key != key) continue;
+            if (slot.expires > now) return &slot;
+            release(slot);
+            ++expirations_;
+            return nullptr;
+        }
+        return nullptr;
+    }
+
+    size_t capacity_;
+    std::vector<Slot> slots;
+    uint64_t seed_1;
+    uint64_t seed_2;
+    size_t size_{0};
+    // live entries with a finite TTL, while zero a full cache has no slot that could free up
+    size_t expiring_{0};
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+    uint64_t evictions_{0};
+    uint64_t expirations_{0};
+};
+
+template <typename Value, typename Clock = std::chrono::steady_clock>
+using CuckooCache = BasicCuckooCache<int, Value, Clock>;
+template <typename Value, typename Clock = std::chrono::steady_clock>
+using CuckooCache64 = BasicCuckooCache<int64_t, Value, Clock>;
+
+#endif
@@ -1,67 +1,118 @@
 #ifndef CUCKOO_HASH
 #define CUCKOO_HASH
 #include <vector>
+#include <memory_resource>
 #include <optional>
 #include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <iterator>
+#include "frozen_cuckoo_hash.hpp"
 
-class CuckooHash{
+//Key is the stored integer type, instantiated for int and int64_t (see aliases at the bottom)
+template <typename Key>
+class BasicCuckooHash{
     public:
-        CuckooHash() : size_index(0), size_(0), capacity_(sizes[size_index]), max_load(0.5), h1(capacity_), h2(capacity_) {
+        using key_type = Key;
+        //Slot arrays draw from a pluggable std::pmr::memory_resource (default heap, huge pages, user arena...)
+        using slot_array = std::pmr::vector<std::optional<Key>>;
+
+        class const_iterator;
+        using iterator = const_iterator;
+
+        BasicCuckooHash() : size_index(0), size_(0), capacity_(capacity_for(size_index)), max_load(0.5), h1(capacity_), h2(capacity_), occupied(bitmap_words(capacity_)) {
             double delta = 0.1;
             max_steps = static_cast<size_t>(
                 std::ceil(6.0 * log_base(static_cast<double>(capacity_), 1.0 + delta/2.0))
             );
         }
 
-        CuckooHash(const std::initializer_list<int>& vals)
+        BasicCuckooHash(const std::initializer_list<Key>& vals)
             : size_index(0),
             size_(0),
-            capacity_(sizes[size_index]),
+            capacity_(capacity_for(size_index)),
             max_load(0.5),
             h1(capacity_),
-            h2(capacity_) {
+            h2(capacity_),
+            occupied(bitmap_words(capacity_)) {
 
                 double delta = 0.1;
                 max_steps = static_cast<size_t>(
                     std::ceil(6.0 * log_base(static_cast<double>(capacity_), 1.0 + delta/2.0))
                 );
-                for (int x : vals){
+                for (Key x : vals){
                     insert(x);
                 }
         }
 
-        explicit CuckooHash(int size_index) : size_index(size_index), size_(0), capacity_(sizes[size_index]), max_load(0.5), max_steps(10), h1(capacity_), h2(capacity_) {}
+        explicit BasicCuckooHash(int size_index) : size_index(size_index), size_(0), capacity_(capacity_for(size_index)), max_steps(10), max_load(0.5), h1(capacity_), h2(capacity_), occupied(bitmap_words(capacity_)) {}
+
+        //Slot arrays (including those allocated by later rehashes) come from resource, which must outlive the table.
+        //Copies of the table allocate from the default resource.
+        BasicCuckooHash(int size_index, std::pmr::memory_resource* resource) : size_index(size_index), size_(0), capacity_(capacity_for(size_index)), max_steps(10), max_load(0.5), h1(capacity_, resource), h2(capacity_, resource), occupied(bitmap_words(capacity_), resource) {}
 
         //Copy constructor and assignment operator
-        CuckooHash(const CuckooHash&) = default;
-        CuckooHash& operator=(const CuckooHash&) = delete;
+        BasicCuckooHash(const BasicCuckooHash&) = default;
+        BasicCuckooHash& operator=(const BasicCuckooHash&) = delete;
 
         //Destructor
-        ~CuckooHash() = default;
+        virtual ~BasicCuckooHash() = default;
+
+        //Outcome of try_insert
+        enum class insert_result { inserted, already_present, needs_growth };
 
         //Main functionality
-        virtual void insert(int key);
-        int contains(int key);
-        std::optional<int> find(int key);
-        bool erase(int key);
+        virtual void insert(Key key);
+        //Inserts without ever rebuilding the table. needs_growth means the table is at its load limit or the eviction
+        //chain ran out of steps; the table is then exactly as before, so call grow() when convenient and retry.
+        //At most max_steps evictions, and no allocation.
+        insert_result try_insert(Key key);
+        //Moves to the next capacity on the sizes ladder and re-inserts every key
+        void grow();
+        int contains(Key key);
+        std::optional<Key> find(Key key);
+        bool erase(Key key);
         void clear();
         bool empty() const;
 
+        //Iteration over stored keys, h1 then h2. Empty slots are skipped 64 at a time through the occupancy bitmap.
+        //Any insert or erase invalidates iterators.
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        //Erases every key for which pred(key) is true in one pass over the occupancy bitmap, returns how many were erased
+        template <typename Pred>
+        size_t erase_if(Pred pred);
+
+        //Looks up n keys in batches: hashes a batch, prefetches its slots, then probes, so the misses overlap.
+        //out[i] is what contains(keys[i]) would return.
+        void contains_batch(const Key* keys, size_t n, int* out);
+
+        //Read-only copy of the current keys with a tight layout and inlined hashes, see frozen_cuckoo_hash.hpp
+        BasicFrozenCuckooHash<Key> freeze() const;
+
         //Getter methods for tests
-        const std::vector<std::optional<int>>& h1_bucket() const;
-        const std::vector<std::optional<int>>& h2_bucket() const;
-        size_t get_hash_1(int key);
-        size_t get_hash_2(int key);
+        const slot_array& h1_bucket() const;
+        const slot_array& h2_bucket() const;
+        std::pmr::memory_resource* resource() const;
+        size_t get_hash_1(Key key);
+        size_t get_hash_2(Key key);
         float load_factor() const;
         size_t size() const;
         size_t capacity() const;
         int times_rehashed() const;
+        int times_reseeded() const;
 
-        virtual size_t hash_1(int key);
-        virtual size_t hash_2(int key);
+        //Per-array capacity used at a given size index. Follows the sizes ladder, then keeps
+        //roughly doubling to the next prime so the table can grow to billions of slots.
+        static size_t capacity_for(size_t size_index);
+
+        virtual size_t hash_1(Key key);
+        virtual size_t hash_2(Key key);
     protected:
         //Capacity sizes for rehash
-        const std::vector<size_t> sizes{13ul, 29ul, 59ul, 127ul, 257ul, 541ul,
+        static inline const std::vector<size_t> sizes{13ul, 29ul, 59ul, 127ul, 257ul, 541ul,
             1'109ul, 2'357ul, 5'087ul, 10'273ul, 20'753ul, 42'043ul,
             85'229ul, 172'933ul, 351'061ul, 712'697ul, 1'447'153ul, 2'938'679ul, 10'000'019ul
         };
@@ -70,14 +121,129 @@ class CuckooHash{
             return std::log(x) / std::log(base);
         }
 
+        //One occupancy bit per slot: bit i is h1[i], bit capacity_ + i is h2[i]
+        static size_t bitmap_words(size_t capacity) {
+            return (2 * capacity + 63) / 64;
+        }
+
+        void mark(size_t bit) { occupied[bit / 64] |= uint64_t{1} << (bit % 64); }
+        void unmark(size_t bit) { occupied[bit / 64] &= ~(uint64_t{1} << (bit % 64)); }
+
+        //Position of the first occupied slot at or after bit, or 2 * capacity_ if there is none
+        size_t next_occupied(size_t bit) const {
+            size_t word = bit / 64;
+            if (word >= occupied.size()) return 2 * capacity_;
+            uint64_t bits = occupied[word] & (~uint64_t{0} << (bit % 64));
+            while (bits == 0){
+                if (++word == occupied.size()) return 2 * capacity_;
+                bits = occupied[word];
+            }
+            return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+        }
+
+        std::optional<Key>& slot_at(size_t bit) { return bit < capacity_ ? h1[bit] : h2[bit - capacity_]; }
+        const std::optional<Key>& slot_at(size_t bit) const { return bit < capacity_ ? h1[bit] : h2[bit - capacity_]; }
+
         //Helper methods
+        //Rebuilds with new_size slots per array. If a key cannot be placed it reseeds or climbs the sizes ladder
+        //and starts over, so capacity_ can end up above new_size.
         virtual void rehash(size_t new_size);
 
+        //Moves size_index to the next rung, counting a rehash, and returns the capacity there
+        size_t next_capacity();
+
+        //Runs the eviction chain for key for at most max_steps. On false the chain ran out, key holds the key left without a slot.
+        bool place(Key& key);
+        //Reverses a failed place, key must be the key it left without a slot
+        void unwind(Key& key);
+
+        //Draws fresh hash parameters so the table can be rebuilt at the same capacity.
+        //Returns false when the hash functions are fixed and cannot be reseeded.
+        virtual bool reseed();
+
+        //Upper bound on in-place reseeds at one capacity before falling back to growth
+        static constexpr int max_reseeds = 8;
+
         size_t size_index, size_, capacity_, max_steps;
         float max_load;
-        std::vector<std::optional<int>> h1, h2;
+        slot_array h1, h2;
+        std::pmr::vector<uint64_t> occupied;
         friend class CuckooHashTest;
         int times_rehashed_ = 0;
+        int times_reseeded_ = 0;
+        int reseeds_at_capacity_ = 0;
 };
 
-#endif
\ No newline at end of file
+template <typename Key>
+class BasicCuckooHash<Key>::const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Key*;
+        using reference = const Key&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return *table->slot_at(position); }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++(){
+            position = table->next_occupied(position + 1);
+            return *this;
+        }
+
+        const_iterator operator++(int){
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+
+    private:
+        friend class BasicCuckooHash;
+        const_iterator(const BasicCuckooHash* table, size_t position) : table(table), position(position) {}
+
+        const BasicCuckooHash* table{nullptr};
+        size_t position{0};
+};
+
+template <typename Key>
+typename BasicCuckooHash<Key>::const_iterator BasicCuckooHash<Key>::begin() const{
+    return const_iterator(this, next_occupied(0));
+}
+
+template <typename Key>
+typename BasicCuckooHash<Key>::const_iterator BasicCuckooHash<Key>::end() const{
+    return const_iterator(this, 2 * capacity_);
+}
+
+template <typename Key>
+template <typename Pred>
+size_t BasicCuckooHash<Key>::erase_if(Pred pred){
+    size_t erased = 0;
+    for (size_t word = 0; word < occupied.size(); ++word){
+        uint64_t bits = occupied[word];
+        while (bits != 0){
+            size_t bit = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+            bits &= bits - 1;
+            std::optional<Key>& slot = slot_at(bit);
+            if (pred(*slot)){
+                slot.reset();
+                unmark(bit);
+                ++erased;
+            }
+        }
+    }
+    size_ -= erased;
+    return erased;
+}
+
+extern template class BasicCuckooHash<int>;
+extern template class BasicCuckooHash<int64_t>;
+
+using CuckooHash = BasicCuckooHash<int>;
+using CuckooHash64 = BasicCuckooHash<int64_t>;
+
+#endif
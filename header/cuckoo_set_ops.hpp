@@ -0,0 +1,94 @@
+#ifndef CUCKOO_SET_OPS
+#define CUCKOO_SET_OPS
+
+#include "cuckoo_hash.hpp"
+#include <vector>
+
+// Union, intersection and difference of two cuckoo tables.
+//
+// Each operation walks the smaller operand with its occupancy-bitmap iterator and probes the larger
+// one through contains_batch(), so the cost follows the smaller table and the random probes into the
+// larger one overlap instead of stalling one by one. The result is a copy of one operand, so it keeps
+// that operand's hash family (RandCuckooHash, KeyedCuckooHash...) and, like every copy, allocates from
+// the default memory resource.
+//
+// Table is CuckooHash or any of its subclasses. Operands are non-const because hashing goes through
+// the virtual hash_1/hash_2.
+namespace cuckoo_set_ops {
+    constexpr size_t batch_size = 256;
+
+    // calls on_key(key, hit) for every key of from, hit telling whether probed contains it
+    template <typename Table, typename OnKey>
+    void probe_all(const Table& from, Table& probed, OnKey&& on_key) {
+        using Key = typename Table::key_type;
+        Key keys[batch_size];
+        int hits[batch_size];
+        size_t count = 0;
+
+        auto flush = [&] {
+            probed.contains_batch(keys, count, hits);
+            for (size_t i = 0; i < count; ++i) on_key(keys[i], hits[i] != -1);
+            count = 0;
+        };
+        for (Key key : from) {
+            keys[count++] = key;
+            if (count == batch_size) flush();
+        }
+        if (count > 0) flush();
+    }
+}
+
+// keys in a or b
+template <typename Table>
+Table table_union(Table& a, Table& b) {
+    Table& larger = a.size() >= b.size() ? a : b;
+    Table& smaller = a.size() >= b.size() ? b : a;
+
+    // collect first, inserting into result while probing it could rehash under the iterator
+    std::vector<typename Table::key_type> missing;
+    cuckoo_set_ops::probe_all(smaller, larger, [&](auto key, bool hit) {
+        if (!hit) missing.push_back(key);
+    });
+
+    Table result(larger);
+    for (auto key : missing) result.insert(key);
+    return result;
+}
+
+// keys in both a and b
+template <typename Table>
+Table table_intersection(Table& a, Table& b) {
+    Table& larger = a.size() >= b.size() ? a : b;
+    Table& smaller = a.size() >= b.size() ? b : a;
+
+    std::vector<typename Table::key_type> missing;
+    cuckoo_set_ops::probe_all(smaller, larger, [&](auto key, bool hit) {
+        if (!hit) missing.push_back(key);
+    });
+
+    Table result(smaller);
+    for (auto key : missing) result.erase(key);
+    return result;
+}
+
+// keys in a but not in b
+template <typename Table>
+Table table_difference(Table& a, Table& b) {
+    std::vector<typename Table::key_type> shared;
+    if (a.size() <= b.size()) {
+        cuckoo_set_ops::probe_all(a, b, [&](auto key, bool hit) {
+            if (hit) shared.push_back(key);
+        });
+    } else {
+        // every key of b that a holds has to go
+        cuckoo_set_ops::probe_all(b, a, [&](auto key, bool hit) {
+            if (hit) shared.push_back(key);
+        });
+    }
+
+    Table result(a);
+    for (auto key : shared) result.erase(key);
+    return result;
+}
+
+#endif
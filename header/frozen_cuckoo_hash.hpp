@@ -0,0 +1,112 @@
+#ifndef FROZEN_CUCKOO_HASH
+#define FROZEN_CUCKOO_HASH
+
+#include "hash_mix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+// Read-only cuckoo set produced by CuckooHash::freeze() for sets that never change after loading.
+//
+// Keys live in one dense array of 4-slot buckets, and each key can sit in either of two buckets.
+// With 4 slots per bucket cuckoo placement succeeds at ~95% load, so the capacity is sized tight
+// and the build searches hash seeds until every key fits. Hashes are fixed, non-virtual and inlined.
+// Unused slots hold a copy of a real key, so no per-slot optional flag is needed.
+template <typename Key>
+class BasicFrozenCuckooHash {
+public:
+    using key_type = Key;
+    static constexpr size_t bucket_slots = 4;
+
+    BasicFrozenCuckooHash() = default;
+    // duplicate keys are stored once. Throws std::runtime_error if no seed pair places the keys even at a
+    // small fraction of max_load
+    explicit BasicFrozenCuckooHash(const std::vector<Key>& keys, double max_load = 0.95);
+
+    // same convention as CuckooHash::contains: 1 or 2 for the bucket holding key, -1 if absent
+    int contains(Key key) const {
+        if (size_ == 0) return -1;
+        if (inBucket(bucket_1(key), key)) return 1;
+        if (inBucket(bucket_2(key), key)) return 2;
+        return -1;
+    }
+
+    std::optional<Key> find(Key key) const {
+        if (contains(key) == -1) return std::nullopt;
+        return key;
+    }
+
+    // index into slot_array() of the slot matching key, or -1. Always the first match in probe order,
+    // so it can key side arrays of per-key payloads even though empty slots repeat a real key.
+    ptrdiff_t slot_of(Key key) const {
+        if (size_ == 0) return -1;
+        ptrdiff_t slot = slotInBucket(bucket_1(key), key);
+        return slot != -1 ? slot : slotInBucket(bucket_2(key), key);
+    }
+
+    // pulls both candidate buckets of key into cache ahead of a later lookup
+    void prefetch(Key key) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (size_ == 0) return;
+        __builtin_prefetch(slots.data() + bucket_1(key) * bucket_slots);
+        __builtin_prefetch(slots.data() + bucket_2(key) * bucket_slots);
+#endif
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots.size(); }
+    float load_factor() const;
+    size_t memory_bytes() const { return slots.capacity() * sizeof(Key); }
+    // number of seeds tried before every key was placed
+    int seed_attempts() const { return seed_attempts_; }
+
+    const std::vector<Key>& slot_array() const { return slots; }
+
+    // Binary image of the table (native byte order), so a built set can be reloaded without the seed search.
+    // load() throws std::runtime_error if the stream does not hold an image with this key width.
+    void save(std::ostream& out) const;
+    static BasicFrozenCuckooHash load(std::istream& in);
+
+private:
+    size_t bucket_1(Key key) const {
+        return static_cast<size_t>(reduce_range(mix64(static_cast<uint64_t>(key) ^ seed_1), buckets));
+    }
+
+    size_t bucket_2(Key key) const {
+        return static_cast<size_t>(reduce_range(mix64(static_cast<uint64_t>(key) ^ seed_2), buckets));
+    }
+
+    bool inBucket(size_t bucket, Key key) const {
+        const Key* b = slots.data() + bucket * bucket_slots;
+        return (b[0] == key) | (b[1] == key) | (b[2] == key) | (b[3] == key);
+    }
+
+    ptrdiff_t slotInBucket(size_t bucket, Key key) const {
+        for (size_t i = 0; i < bucket_slots; ++i) {
+            if (slots[bucket * bucket_slots + i] == key) return static_cast<ptrdiff_t>(bucket * bucket_slots + i);
+        }
+        return -1;
+    }
+
+    // tries to place every key with the current seeds, false if some eviction chain fails
+    bool build(const std::vector<Key>& keys);
+
+    std::vector<Key> slots;
+    size_t buckets{0};
+    size_t size_{0};
+    uint64_t seed_1{0};
+    uint64_t seed_2{0};
+    int seed_attempts_{0};
+};
+
+extern template class BasicFrozenCuckooHash<int>;
+extern template class BasicFrozenCuckooHash<int64_t>;
+
+using FrozenCuckooHash = BasicFrozenCuckooHash<int>;
+using FrozenCuckooHash64 = BasicFrozenCuckooHash<int64_t>;
+
+#endif
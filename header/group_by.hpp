@@ -0,0 +1,146 @@
+#ifndef GROUP_BY
+#define GROUP_BY
+
+#include "hash_mix.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Running aggregate for one group
+struct Accumulator {
+    int64_t count{0};
+    int64_t sum{0};
+
+    void add(int64_t value) {
+        ++count;
+        sum += value;
+    }
+
+    void merge(const Accumulator& other) {
+        count += other.count;
+        sum += other.sum;
+    }
+};
+
+// Cuckoo map from key to Accumulator, with two candidate 4-slot buckets per key.
+// upsert() finds or creates a key's accumulator in a single probe and returns it for in-place
+// update, so hot keys never pay the contains-then-insert double probe of CuckooHash::insert.
+template <typename Key>
+class BasicAccumulatorMap {
+public:
+    static constexpr size_t bucket_slots = 4;
+
+    explicit BasicAccumulatorMap(size_t expected_keys = 0);
+    // seeded from seed instead of std::random_device, for maps derived from one parent seed
+    BasicAccumulatorMap(size_t expected_keys, uint64_t seed);
+
+    // accumulator for key, zero-initialised if key was absent. Valid until the next upsert or merge.
+    Accumulator& upsert(Key key) { return upsert(key, hash(key)); }
+    // same, with hash(key) already computed, e.g. by a batch that prefetched it
+    Accumulator& upsert(Key key, uint64_t hash);
+    const Accumulator* find(Key key) const;
+    void merge(const BasicAccumulatorMap& other);
+
+    // one 64-bit hash gives both candidate buckets, high half the first and low half the second
+    uint64_t hash(Key key) const {
+        return mix64(static_cast<uint64_t>(key) ^ seed);
+    }
+
+    // pulls both candidate buckets into cache ahead of an upsert
+    void prefetch(uint64_t hash) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets[bucket_1(hash)]);
+        __builtin_prefetch(&buckets[bucket_2(hash)]);
+#endif
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return buckets.size() * bucket_slots; }
+    float load_factor() const;
+    int times_rehashed() const { return times_rehashed_; }
+
+    // calls fn(key, accumulator) for every group
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Bucket& bucket : buckets) {
+            for (uint8_t i = 0; i < bucket.used; ++i) fn(bucket.keys[i], bucket.accumulators[i]);
+        }
+    }
+
+private:
+    // cache-line aligned with the keys first, so a probe only touches the first line of a bucket
+    struct alignas(64) Bucket {
+        Key keys[bucket_slots];
+        uint8_t used{0};
+        Accumulator accumulators[bucket_slots];
+    };
+
+    // grow once the map is this full, 4-slot buckets cope well up to ~95%
+    static constexpr double max_load = 0.9;
+    static constexpr int max_kicks = 500;
+
+    size_t bucket_1(uint64_t hash) const {
+        return static_cast<size_t>(reduce_range(hash, buckets.size()));
+    }
+
+    size_t bucket_2(uint64_t hash) const {
+        return static_cast<size_t>(reduce_range(hash << 32, buckets.size()));
+    }
+
+    Accumulator* probe(Key key, uint64_t hash);
+    // places a key known to be absent, false if the eviction chain fails (the homeless entry is left in key/acc)
+    bool place(Key& key, Accumulator& acc);
+    void rehash(size_t new_buckets);
+
+    std::vector<Bucket> buckets;
+    size_t size_{0};
+    uint64_t seed;
+    uint64_t kick_state;
+    int times_rehashed_{0};
+};
+
+// Parallel group-by: each thread aggregates its slice of the input into thread-local maps, one per
+// hash partition, then thread p merges partition p of every thread into the result, so the combine
+// runs in parallel with no locking. run() can be called repeatedly to stream batches in.
+template <typename Key>
+class BasicGroupBy {
+public:
+    explicit BasicGroupBy(unsigned threads = std::thread::hardware_concurrency(), size_t partitions = 0);
+
+    // adds values[i] to the group of keys[i], throws std::invalid_argument if the sizes differ
+    void run(const std::vector<Key>& keys, const std::vector<int64_t>& values);
+
+    const Accumulator* find(Key key) const;
+    size_t size() const;
+    size_t partition_count() const { return result.size(); }
+    const BasicAccumulatorMap<Key>& partition(size_t p) const { return result[p]; }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& map : result) map.for_each(fn);
+    }
+
+private:
+    size_t partitionOf(Key key) const {
+        return static_cast<size_t>(reduce_range(mix64(static_cast<uint64_t>(key) ^ partition_seed), result.size()));
+    }
+
+    static constexpr uint64_t partition_seed = 0x9e3779b97f4a7c15ull;
+
+    unsigned threads;
+    // drawn once per GroupBy, every map's seed is split off it
+    uint64_t seed_state;
+    std::vector<BasicAccumulatorMap<Key>> result;
+};
+
+extern template class BasicAccumulatorMap<int>;
+extern template class BasicAccumulatorMap<int64_t>;
+extern template class BasicGroupBy<int>;
+extern template class BasicGroupBy<int64_t>;
+
+using AccumulatorMap = BasicAccumulatorMap<int>;
+using AccumulatorMap64 = BasicAccumulatorMap<int64_t>;
+using GroupBy = BasicGroupBy<int>;
+using GroupBy64 = BasicGroupBy<int64_t>;
+
+#endif
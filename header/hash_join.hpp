@@ -0,0 +1,69 @@
+#ifndef HASH_JOIN
+#define HASH_JOIN
+
+#include "frozen_cuckoo_hash.hpp"
+#include <cstdint>
+#include <vector>
+
+// In-memory equi-join with a cuckoo table on the build side.
+//
+// Build: the distinct build keys are bulk loaded into a FrozenCuckooHash, and the build row ids
+// are grouped per key in one flat array indexed through the key's slot, so duplicate build keys
+// are fine. Probe: keys are processed in batches of batch_size, first hashing and prefetching every
+// key's buckets, then resolving the batch, so the cache misses of a batch overlap. Matching
+// (build row, probe row) pairs go into caller-provided output buffers.
+template <typename Key>
+class BasicHashJoin {
+public:
+    using row_id = uint32_t;
+    static constexpr size_t batch_size = 16;
+
+    // row ids are positions in build_column
+    explicit BasicHashJoin(const std::vector<Key>& build_column);
+
+    // Joins probe_column[0, n) against the build side, numbering probe rows from first_row.
+    // Writes at most out_capacity pairs to out_build/out_probe and returns how many were written.
+    // Stops before a probe row whose matches do not all fit; *rows_consumed is the number of probe
+    // rows fully handled, so the caller can drain the buffers and resume from there. out_capacity
+    // must be at least max_matches_per_row() to guarantee progress.
+    size_t probe(const Key* probe_column, size_t n, row_id first_row,
+                 row_id* out_build, row_id* out_probe, size_t out_capacity, size_t* rows_consumed) const;
+
+    // Output of one probe partition
+    struct Partition {
+        std::vector<row_id> build_rows;
+        std::vector<row_id> probe_rows;
+    };
+
+    // Splits probe_column into one contiguous range per thread and probes them in parallel.
+    // Partition i holds the matches for the i-th range, in probe row order.
+    std::vector<Partition> join(const std::vector<Key>& probe_column, unsigned threads = 1) const;
+
+    size_t build_rows() const { return rows.size(); }
+    size_t distinct_keys() const { return table.size(); }
+    size_t max_matches_per_row() const { return max_group; }
+
+private:
+    // range in rows of one key's build row ids
+    struct Group {
+        uint32_t begin;
+        uint32_t count;
+    };
+
+    void probePartition(const std::vector<Key>& probe_column, size_t begin, size_t end, Partition& out) const;
+
+    BasicFrozenCuckooHash<Key> table;
+    // indexed by the key's canonical slot in table, begin and count share a cache line
+    std::vector<Group> groups;
+    // build row ids grouped by key
+    std::vector<row_id> rows;
+    size_t max_group{0};
+};
+
+extern template class BasicHashJoin<int>;
+extern template class BasicHashJoin<int64_t>;
+
+using HashJoin = BasicHashJoin<int>;
+using HashJoin64 = BasicHashJoin<int64_t>;
+
+#endif
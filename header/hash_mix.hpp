@@ -0,0 +1,77 @@
+#ifndef HASH_MIX
+#define HASH_MIX
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// murmur3 64-bit finaliser, good avalanche for sequential and clustered keys.
+// Shared by the tables that use fixed seeded hashes instead of virtual hash_1/hash_2.
+constexpr uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// maps the top 32 bits of a hash onto [0, n) without a division, n must be below 2^32
+constexpr uint64_t reduce_range(uint64_t hash, uint64_t n) {
+    return ((hash >> 32) * n) >> 32;
+}
+
+// full 128-bit product of two 64-bit values. unsigned __int128 is a GCC/Clang extension, so MSVC uses
+// _umul128 on x64 and anything else falls back to four 32-bit partial products
+struct wide_product {
+    uint64_t low;
+    uint64_t high;
+};
+
+inline wide_product mul_wide(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    return {low, high};
+#else
+    uint64_t a_lo = a & 0xffffffffull, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xffffffffull, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+    return {(cross << 32) | (lo_lo & 0xffffffffull), hi_hi + (hi_lo >> 32) + (cross >> 32)};
+#endif
+}
+
+inline wide_product add_wide(wide_product x, uint64_t y) {
+    uint64_t low = x.low + y;
+    return {low, x.high + (low < y ? 1 : 0)};
+}
+
+inline wide_product add_wide(wide_product x, wide_product y) {
+    wide_product sum = add_wide(x, y.low);
+    sum.high += y.high;
+    return sum;
+}
+
+constexpr uint64_t mersenne_61 = (uint64_t{1} << 61) - 1;
+
+// x mod (2^61 - 1) for x < 2^122, using the Mersenne shift-and-add reduction
+inline uint64_t mod_mersenne_61(wide_product x) {
+    uint64_t result = (x.low & mersenne_61) + ((x.low >> 61) | (x.high << 3));
+    result = (result & mersenne_61) + (result >> 61);
+    return result >= mersenne_61 ? result - mersenne_61 : result;
+}
+
+// Carter-Wegman hash of a 64-bit key over p = 2^61 - 1: (a * k_hi + c * k_lo + b) mod p. The key is split
+// into 32-bit halves so each part is below p, which keeps the family universal over all 64-bit keys
+inline uint64_t carter_wegman_61(uint64_t a, uint64_t b, uint64_t c, uint64_t key) {
+    wide_product sum = add_wide(mul_wide(a, key >> 32), mul_wide(c, key & 0xffffffffull));
+    return mod_mersenne_61(add_wide(sum, b));
+}
+
+#endif
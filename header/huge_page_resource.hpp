@@ -0,0 +1,42 @@
+#ifndef HUGE_PAGE_RESOURCE
+#define HUGE_PAGE_RESOURCE
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+// Memory resource for large slot arrays. Allocations of at least min_mapping bytes
+// are served by anonymous mmap, aligned to and rounded up to 2 MiB, and advised with
+// MADV_HUGEPAGE so transparent huge pages back them and random probes stop paying a
+// TLB miss per 4 KiB page. Smaller allocations go to the upstream resource.
+//
+// Pass it (or any other std::pmr::memory_resource, e.g. a monotonic_buffer_resource
+// over a user arena) to the table constructors that take a resource.
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t huge_page_size = size_t{2} << 20;
+
+    // prefault touches every huge page up front so no probe takes a page fault later
+    explicit HugePageResource(size_t min_mapping = huge_page_size / 2, bool prefault = false,
+                              std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : min_mapping(min_mapping), prefault(prefault), upstream(upstream) {}
+
+    // number of bytes currently mapped by this resource, for tests and benchmarks
+    size_t mapped_bytes() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    static size_t roundUp(size_t bytes) {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+    size_t min_mapping;
+    bool prefault;
+    std::pmr::memory_resource* upstream;
+    std::atomic<size_t> mapped{0};
+};
+
+#endif
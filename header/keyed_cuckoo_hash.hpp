@@ -0,0 +1,64 @@
+#ifndef KEYED_CUCKOO_HASH
+#define KEYED_CUCKOO_HASH
+
+#include "cuckoo_hash.hpp"
+#include <cstdint>
+#include <optional>
+#include <random>
+
+// Cuckoo hash table for keys that come from untrusted input. Both hashes are
+// SipHash-2-4 keyed with secret 128-bit keys drawn at construction, so an
+// attacker who cannot observe the keys cannot craft colliding inputs. When an
+// eviction chain blows up below the load threshold, the keys are redrawn and
+// the table is rebuilt at the same capacity instead of growing.
+template <typename Key>
+class BasicKeyedCuckooHash : public BasicCuckooHash<Key> {
+public:
+    BasicKeyedCuckooHash() : BasicCuckooHash<Key>() {
+        genNewKeys();
+    }
+
+    explicit BasicKeyedCuckooHash(int size_index) : BasicCuckooHash<Key>(size_index) {
+        genNewKeys();
+    }
+
+    // slot arrays are allocated from resource, which must outlive the table
+    BasicKeyedCuckooHash(int size_index, std::pmr::memory_resource* resource) : BasicCuckooHash<Key>(size_index, resource) {
+        genNewKeys();
+    }
+
+    // fixed seed makes the secret keys reproducible, only use for testing
+    BasicKeyedCuckooHash(int size_index, uint64_t seed) : BasicCuckooHash<Key>(size_index), generator(std::in_place, seed) {
+        genNewKeys();
+    }
+
+    size_t hash_1(Key key) override;
+    size_t hash_2(Key key) override;
+
+protected:
+    void rehash(size_t new_size) override;
+    bool reseed() override;
+
+private:
+    void genNewKeys();
+
+    // SipHash-2-4 of a single 8 byte message
+    static uint64_t sipHash(uint64_t k0, uint64_t k1, uint64_t message);
+
+    // independent secret keys for each hash function
+    uint64_t k1_0{};
+    uint64_t k1_1{};
+    uint64_t k2_0{};
+    uint64_t k2_1{};
+
+    // only set by the seeded test constructor, otherwise every key is drawn straight from std::random_device
+    std::optional<std::mt19937_64> generator;
+};
+
+extern template class BasicKeyedCuckooHash<int>;
+extern template class BasicKeyedCuckooHash<int64_t>;
+
+using KeyedCuckooHash = BasicKeyedCuckooHash<int>;
+using KeyedCuckooHash64 = BasicKeyedCuckooHash<int64_t>;
+
+#endif
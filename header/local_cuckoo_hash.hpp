@@ -0,0 +1,110 @@
+#ifndef LOCAL_CUCKOO_HASH
+#define LOCAL_CUCKOO_HASH
+
+#include "hash_mix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <random>
+#include <vector>
+
+// Cuckoo set with both candidate buckets of a key in one interleaved array, the second one inside the
+// same 4 KiB page as the first.
+//
+// In CuckooHash a key's two slots, h1[hash_1(k)] and h2[hash_2(k)], are unrelated locations in two
+// separate arrays, so every kick of an eviction chain is a fresh cache and TLB miss. Here the array is
+// split into page-aligned windows of small buckets; a key's first bucket comes from its hash and its
+// second bucket is the first one's offset inside the window XORed with a tag taken from the same hash.
+// XOR makes the choice symmetric, so a kicked key finds its other bucket from the bucket it sits in,
+// and a whole eviction chain stays inside one page.
+//
+// Buckets hold several keys because a window is a much smaller cuckoo graph than the whole table:
+// with single-slot buckets one unlucky window caps the load well below CuckooHash's.
+template <typename Key>
+class BasicLocalCuckooHash {
+public:
+    using key_type = Key;
+    using slot_type = std::optional<Key>;
+
+    static constexpr size_t page_bytes = 4096;
+    static constexpr size_t bucket_slots = 4;
+    // buckets per window, a power of two so the XOR stays inside it
+    static constexpr size_t window_buckets = page_bytes / (bucket_slots * sizeof(slot_type));
+    static constexpr size_t window_slots = window_buckets * bucket_slots;
+    static_assert((window_buckets & (window_buckets - 1)) == 0, "window must be a power of two");
+
+    // same starting capacity and growth ladder as CuckooHash(size_index), grows past max_load
+    explicit BasicLocalCuckooHash(int size_index = 0, uint64_t seed = std::random_device{}(), float max_load = 0.5);
+
+    void insert(Key key);
+    // 1 if key is in its first bucket, 2 if in its alternate, -1 if absent
+    int contains(Key key) const;
+    std::optional<Key> find(Key key) const;
+    bool erase(Key key);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots.size(); }
+    float load_factor() const { return static_cast<float>(size_) / static_cast<float>(slots.size()); }
+    int times_rehashed() const { return times_rehashed_; }
+
+private:
+    // page-aligned storage, so windows line up with pages
+    template <typename T>
+    struct PageAllocator {
+        using value_type = T;
+        PageAllocator() = default;
+        template <typename U>
+        PageAllocator(const PageAllocator<U>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{page_bytes})); }
+        void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t{page_bytes}); }
+
+        bool operator==(const PageAllocator&) const { return true; }
+    };
+
+    static constexpr int max_kicks = 500;
+
+    uint64_t hash(Key key) const {
+        return mix64(static_cast<uint64_t>(key) ^ seed);
+    }
+
+    size_t first_bucket(uint64_t h) const {
+        return static_cast<size_t>(reduce_range(h, slots.size() / bucket_slots));
+    }
+
+    // never zero, so the two buckets always differ
+    static size_t tag(uint64_t h) {
+        return 1 + static_cast<size_t>(h & 0xffff) % (window_buckets - 1);
+    }
+
+    // the other candidate bucket of key, given the one it is in (or would be in)
+    static size_t alternate(size_t bucket, uint64_t h) {
+        return bucket ^ tag(h);
+    }
+
+    // index of key (or of the first empty slot) within bucket, bucket_slots if there is none
+    size_t find_in(size_t bucket, Key key) const;
+    size_t empty_in(size_t bucket) const;
+
+    // places a key known to be absent, false if the eviction chain ran out with the homeless key left in key
+    bool place(Key& key);
+    // rebuilds at the next rung of the ladder with a fresh seed, then places pending
+    void grow(Key pending);
+
+    std::vector<slot_type, PageAllocator<slot_type>> slots;
+    size_t size_index;
+    size_t size_{0};
+    float max_load;
+    uint64_t seed;
+    std::mt19937_64 generator;
+    int times_rehashed_{0};
+};
+
+extern template class BasicLocalCuckooHash<int>;
+extern template class BasicLocalCuckooHash<int64_t>;
+
+using LocalCuckooHash = BasicLocalCuckooHash<int>;
+using LocalCuckooHash64 = BasicLocalCuckooHash<int64_t>;
+
+#endif
@@ -2,11 +2,13 @@
 #define RAND_CUCKOO_HASH
 
 #include "cuckoo_hash.hpp"
+#include "hash_mix.hpp"
 #include <random>
 
-class RandCuckooHash : public CuckooHash {
+template <typename Key>
+class BasicRandCuckooHash : public BasicCuckooHash<Key> {
 public:
-    RandCuckooHash() : CuckooHash(), generator(std::random_device{}()) {
+    BasicRandCuckooHash() : BasicCuckooHash<Key>(), generator(std::random_device{}()) {
         // call standard CuckooHash constructor and init random generator
         // then generate the hashes
         genNewHashes();
@@ -15,7 +17,7 @@ public:
         this->printHash2();
     }
 
-    explicit RandCuckooHash(int size_index, bool suppress_logs = false) : CuckooHash(size_index), generator(std::random_device{}()), suppress_logs(suppress_logs) {
+    explicit BasicRandCuckooHash(int size_index, bool suppress_logs = false) : BasicCuckooHash<Key>(size_index), generator(std::random_device{}()), suppress_logs(suppress_logs) {
         // choose starting capacity with ctor argument, allow user to suppress logs
         genNewHashes();
 
@@ -23,8 +25,11 @@ public:
         this->printHash2();
     }
 
-    explicit RandCuckooHash(int size_index, int32_t seed = (int) std::random_device{}(), bool suppress_logs = false) : CuckooHash(size_index), generator(seed), suppress_logs(suppress_logs) {
+    explicit BasicRandCuckooHash(int size_index, int32_t seed = (int) std::random_device{}(), bool suppress_logs = false,
+                                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : BasicCuckooHash<Key>(size_index, resource), generator(seed), suppress_logs(suppress_logs) {
         // choose starting capacity with ctor argument, allow user to set seed and/or suppress logs
+        // and to allocate the slot arrays from their own memory resource
         genNewHashes();
 
         this->printHash1();
@@ -35,30 +40,40 @@ public:
     void printHash2();
 
     // following are only public for testing
-    size_t hash_1(int key) override;
-    size_t hash_2(int key) override;
+    size_t hash_1(Key key) override;
+    size_t hash_2(Key key) override;
 
     // below will break any hash table, only use for testing
     void genNewHashes();
 
 protected:
     void rehash(size_t new_size) override;
+    bool reseed() override;
 
 private:
-    // max_int for int32_t ints is prime, so it
-    // can serve as p from Carter and Wegmans' equation
-    static constexpr uint32_t modulus_p = 2'147'483'647;
-
-    uint32_t a1{};
-    uint32_t b1{};
-    uint32_t a2{};
-    uint32_t b2{};
+    // 32-bit keys: max_int for int32_t ints is prime, so it
+    // can serve as p from Carter and Wegmans' equation.
+    // 64-bit keys: use the Mersenne prime 2^61 - 1 instead, and hash
+    // the key as two 32-bit halves so every 64-bit key stays below p
+    static constexpr bool wide_keys = sizeof(Key) > sizeof(int32_t);
+    static constexpr uint64_t modulus_p = wide_keys ? mersenne_61 : 2'147'483'647;
+
+    // h(k) = ((a * k + b) mod p) mod m for 32-bit keys
+    // h(k) = ((a * k_hi + c * k_lo + b) mod p) mod m for 64-bit keys
+    uint64_t a1{};
+    uint64_t b1{};
+    uint64_t c1{};
+    uint64_t a2{};
+    uint64_t b2{};
+    uint64_t c2{};
 
     std::mt19937 generator;
 
     // hide logs to reduce test output clutter
     bool suppress_logs{};
 
+    size_t universalHash(Key key, uint64_t a, uint64_t b, uint64_t c) const;
+
     // c++'s % is really just a remainder operator, use
     // mathematical modulo to ensure universal hash family
     // when working with negative keys
@@ -67,6 +82,13 @@ private:
         if (result < 0) result = result + p;
         return result;
     }
+
 };
 
-#endif
\ No newline at end of file
+extern template class BasicRandCuckooHash<int>;
+extern template class BasicRandCuckooHash<int64_t>;
+
+using RandCuckooHash = BasicRandCuckooHash<int>;
+using RandCuckooHash64 = BasicRandCuckooHash<int64_t>;
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef READ_MOSTLY_CUCKOO_HASH
+#define READ_MOSTLY_CUCKOO_HASH
+
+#include "cuckoo_hash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// RCU-style wrapper for sets that are rebuilt occasionally and queried constantly from many threads.
+//
+// Writers never touch the published table: update() copies it with the table's copy constructor,
+// modifies the copy and publishes it with an atomic pointer swap (publish() swaps in a table built
+// elsewhere). Readers take a Reader handle, one per thread, and run wait-free lookups on whichever
+// immutable snapshot was current when the lookup started.
+//
+// Replaced snapshots are reclaimed with epoch-based reclamation: every publish advances a global
+// epoch, readers announce the epoch they entered in their own slot, and a retired snapshot is
+// deleted once no reader is still inside an epoch at or before the one it was retired in.
+//
+// Table is CuckooHash or any of its subclasses (RandCuckooHash, KeyedCuckooHash, the 64-bit variants).
+template <typename Table>
+class ReadMostlyCuckooHash {
+public:
+    using key_type = typename Table::key_type;
+
+    class Reader;
+
+    explicit ReadMostlyCuckooHash(std::unique_ptr<Table> initial, size_t max_readers = 256)
+        : current(initial.release()), reader_slots(max_readers), max_readers(max_readers) {}
+
+    ReadMostlyCuckooHash(const ReadMostlyCuckooHash&) = delete;
+    ReadMostlyCuckooHash& operator=(const ReadMostlyCuckooHash&) = delete;
+
+    // all Reader handles must be gone before the wrapper is destroyed
+    ~ReadMostlyCuckooHash() {
+        delete current.load();
+        for (auto& [table, epoch] : retired) delete table;
+    }
+
+    // claims a reader slot, throws if max_readers handles are already alive
+    Reader reader() {
+        for (size_t i = 0; i < max_readers; ++i) {
+            bool expected = false;
+            if (reader_slots[i].claimed.compare_exchange_strong(expected, true)) return Reader(this, &reader_slots[i]);
+        }
+        throw std::runtime_error("No free reader slots");
+    }
+
+    // copies the current snapshot, applies modify to the copy and publishes it
+    template <typename Modify>
+    void update(Modify&& modify) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        auto copy = std::make_unique<Table>(*current.load());
+        std::forward<Modify>(modify)(*copy);
+        swapIn(std::move(copy));
+    }
+
+    // publishes a table built elsewhere, e.g. a full rebuild
+    void publish(std::unique_ptr<Table> table) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        swapIn(std::move(table));
+    }
+
+    // frees retired snapshots that no reader can still see, returns how many remain
+    size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        return reclaimRetired();
+    }
+
+    size_t retired_count() const {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        return retired.size();
+    }
+
+    uint64_t epoch() const {
+        return global_epoch.load();
+    }
+
+private:
+    static constexpr uint64_t idle = UINT64_MAX;
+
+    // one cache line per reader so announcing an epoch never contends with other readers
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{idle};
+        std::atomic<bool> claimed{false};
+    };
+
+    // caller holds writer_mutex
+    void swapIn(std::unique_ptr<Table> table) {
+        Table* old = current.exchange(table.release());
+        retired.emplace_back(old, global_epoch.fetch_add(1));
+        reclaimRetired();
+    }
+
+    // caller holds writer_mutex
+    size_t reclaimRetired() {
+        uint64_t oldest_active = idle;
+        for (const ReaderSlot& slot : reader_slots) {
+            oldest_active = std::min(oldest_active, slot.epoch.load());
+        }
+
+        size_t kept = 0;
+        for (auto& [table, epoch] : retired) {
+            if (epoch < oldest_active) delete table;
+            else retired[kept++] = {table, epoch};
+        }
+        retired.resize(kept);
+        return kept;
+    }
+
+    std::atomic<Table*> current;
+    std::atomic<uint64_t> global_epoch{0};
+    std::vector<ReaderSlot> reader_slots;
+    size_t max_readers;
+
+    mutable std::mutex writer_mutex;
+    std::vector<std::pair<Table*, uint64_t>> retired;
+
+public:
+    // Per-thread read handle. Lookups are wait-free: announce the epoch, load the snapshot,
+    // probe it and leave, with no locks, retries or writes to shared cache lines.
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept : owner(std::exchange(other.owner, nullptr)), slot(std::exchange(other.slot, nullptr)) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        ~Reader() {
+            if (slot) slot->claimed.store(false);
+        }
+
+        int contains(key_type key) {
+            return read([key](Table& table) { return table.contains(key); });
+        }
+
+        std::optional<key_type> find(key_type key) {
+            return read([key](Table& table) { return table.find(key); });
+        }
+
+        size_t size() {
+            return read([](Table& table) { return table.size(); });
+        }
+
+        // runs fn against one consistent snapshot, fn must not modify the table or keep references to it
+        template <typename Fn>
+        auto read(Fn&& fn) {
+            slot->epoch.store(owner->global_epoch.load());
+            struct Leave {
+                ReaderSlot* slot;
+                ~Leave() { slot->epoch.store(idle, std::memory_order_release); }
+            } leave{slot};
+            return std::forward<Fn>(fn)(*owner->current.load());
+        }
+
+    private:
+        friend class ReadMostlyCuckooHash;
+        Reader(ReadMostlyCuckooHash* owner, ReaderSlot* slot) : owner(owner), slot(slot) {}
+
+        ReadMostlyCuckooHash* owner;
+        ReaderSlot* slot;
+    };
+};
+
+#endif
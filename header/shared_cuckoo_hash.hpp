@@ -0,0 +1,125 @@
+#ifndef SHARED_CUCKOO_HASH
+#define SHARED_CUCKOO_HASH
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Cuckoo set whose slot arrays and hash parameters live in a POSIX shared-memory segment, so
+// pre-forked workers can all query one table instead of each building their own RandCuckooHash.
+//
+// The segment holds a fixed header followed by the two slot arrays at offsets computed from the
+// capacity, with no pointers inside, so every process can map it at a different address.
+// One process creates the table and is its only writer; any number of processes open it read-only.
+//
+// Consistency uses a seqlock: the writer makes the sequence number odd for the duration of each
+// modification (including eviction chains, reseeds and growth) and even again afterwards. Readers
+// retry a lookup if the sequence was odd or changed while they read, so they never observe a key
+// halfway through a cuckoo move. Growth enlarges the segment in place; readers notice the larger
+// capacity and remap.
+//
+// Hashes are Carter and Wegman over the Mersenne prime 2^61 - 1, as in RandCuckooHash64.
+template <typename Key>
+class BasicSharedCuckooHash {
+public:
+    // creates (or replaces) the named segment and opens it for writing
+    static BasicSharedCuckooHash create(const std::string& name, size_t expected_keys = 0);
+    // opens an existing segment read-only
+    static BasicSharedCuckooHash open(const std::string& name);
+    // removes the name, mappings that are already open stay valid
+    static void unlink(const std::string& name);
+
+    BasicSharedCuckooHash(BasicSharedCuckooHash&& other) noexcept;
+    BasicSharedCuckooHash(const BasicSharedCuckooHash&) = delete;
+    BasicSharedCuckooHash& operator=(const BasicSharedCuckooHash&) = delete;
+    BasicSharedCuckooHash& operator=(BasicSharedCuckooHash&&) = delete;
+    ~BasicSharedCuckooHash();
+
+    //Writer functionality, throws std::logic_error on a read-only mapping
+    void insert(Key key);
+    bool erase(Key key);
+
+    //Reader functionality, safe while the writer is modifying the table
+    int contains(Key key);
+    std::optional<Key> find(Key key);
+    size_t size();
+    size_t capacity();
+    bool empty();
+
+    int times_rehashed() const;
+    uint64_t sequence() const;
+
+private:
+    struct Slot {
+        std::atomic<Key> key;
+        std::atomic<uint32_t> used;
+    };
+    // every process maps the same bytes, so each atomic the segment stores must be lock-free
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free &&
+                      std::atomic<Key>::is_always_lock_free,
+                  "shared slots need address-free atomics");
+
+    struct Header {
+        // written last with release ordering, readers load it with acquire before trusting the rest
+        std::atomic<uint64_t> magic;
+        uint32_t key_size;
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> capacity;
+        std::atomic<uint64_t> size;
+        std::atomic<uint64_t> size_index;
+        std::atomic<uint64_t> times_rehashed;
+        // h(k) = ((a * k_hi + c * k_lo + b) mod p) mod capacity
+        std::atomic<uint64_t> a1, b1, c1, a2, b2, c2;
+    };
+
+    static constexpr uint64_t magic_value = 0x4375636b6f6f5348ull;
+    static constexpr float max_load = 0.5;
+    // reseeds tried at one capacity before a rebuild grows instead
+    static constexpr int max_reseeds = 8;
+    static constexpr size_t max_kicks = 500;
+
+    BasicSharedCuckooHash(int fd, bool writable, std::string name);
+
+    static size_t slotsOffset();
+    static size_t segmentBytes(size_t capacity);
+
+    Header* header() const { return static_cast<Header*>(base); }
+    Slot* h1() const;
+    Slot* h2() const;
+
+    size_t hash(Key key, uint64_t a, uint64_t b, uint64_t c, size_t capacity) const;
+    // maps the whole current segment, replacing any previous mapping
+    void map(size_t bytes);
+    void requireWriter() const;
+    // runs fn(capacity) until it completes with no write in progress and none started meanwhile
+    template <typename Fn>
+    auto consistentRead(Fn&& fn);
+
+    //Writer helpers, called with the sequence number odd
+    void beginWrite();
+    void endWrite();
+    void genNewHashes();
+    // false if the eviction chain ran out, with the homeless key left in key
+    bool place(Key& key);
+    std::vector<Key> collectKeys() const;
+    // lays out new_capacity slots per array with fresh hashes and places keys, growing if reseeds keep failing
+    void rebuild(const std::vector<Key>& keys, size_t new_capacity);
+
+    int fd;
+    bool writable;
+    std::string name;
+    void* base{nullptr};
+    size_t mapped_bytes{0};
+    std::mt19937_64 generator;
+};
+
+extern template class BasicSharedCuckooHash<int>;
+extern template class BasicSharedCuckooHash<int64_t>;
+
+using SharedCuckooHash = BasicSharedCuckooHash<int>;
+using SharedCuckooHash64 = BasicSharedCuckooHash<int64_t>;
+
+#endif
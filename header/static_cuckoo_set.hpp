@@ -0,0 +1,128 @@
+#ifndef STATIC_CUCKOO_SET
+#define STATIC_CUCKOO_SET
+
+#include "hash_mix.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+// Fixed-capacity cuckoo set built entirely at compile time, for lookup tables known at build time
+// (opcode tables, reserved IDs...). The constructor is constexpr: it searches hash seeds until every
+// key is placed with no stash, so a constexpr or constinit set ends up as static arrays with fixed
+// hash parameters, no heap and no startup work.
+//
+//     constexpr auto reserved = make_static_cuckoo_set({0, 1, 2, 255});
+//     static_assert(reserved.contains(255) != -1);
+//
+// Same layout as FrozenCuckooHash: 4-slot buckets, two candidate buckets per key, and empty slots
+// holding a copy of a real key. Capacity is sized for a 75% load so the seed search stays short
+// enough for the compiler's constexpr evaluation limits. Keys must be distinct.
+template <typename Key, size_t N>
+class StaticCuckooSet {
+public:
+    using key_type = Key;
+    static constexpr size_t bucket_slots = 4;
+    static constexpr size_t buckets = N / 3 + 1;
+
+    constexpr explicit StaticCuckooSet(const std::array<Key, N>& keys) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = i + 1; j < N; ++j) {
+                if (keys[i] == keys[j]) throw std::logic_error("StaticCuckooSet keys must be distinct");
+            }
+        }
+        if constexpr (N == 0) return;
+
+        uint64_t state = 0x5eed5eed5eed5eedull;
+        for (int attempt = 0; attempt < max_seed_attempts; ++attempt) {
+            seed_1 = splitmix(state);
+            seed_2 = splitmix(state);
+            if (build(keys)) return;
+        }
+        throw std::logic_error("StaticCuckooSet found no seeds that place every key");
+    }
+
+    // same convention as CuckooHash::contains: 1 or 2 for the bucket holding key, -1 if absent
+    constexpr int contains(Key key) const {
+        if constexpr (N == 0) return -1;
+        if (inBucket(bucket_1(key), key)) return 1;
+        if (inBucket(bucket_2(key), key)) return 2;
+        return -1;
+    }
+
+    constexpr std::optional<Key> find(Key key) const {
+        if (contains(key) == -1) return std::nullopt;
+        return key;
+    }
+
+    constexpr bool empty() const { return N == 0; }
+    constexpr size_t size() const { return N; }
+    constexpr size_t capacity() const { return slots.size(); }
+
+private:
+    static constexpr int max_seed_attempts = 256;
+    static constexpr int max_kicks = 200;
+
+    static constexpr uint64_t splitmix(uint64_t& state) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr size_t bucket_1(Key key) const {
+        return static_cast<size_t>(mix64(static_cast<uint64_t>(key) ^ seed_1) % buckets);
+    }
+
+    constexpr size_t bucket_2(Key key) const {
+        return static_cast<size_t>(mix64(static_cast<uint64_t>(key) ^ seed_2) % buckets);
+    }
+
+    constexpr bool inBucket(size_t bucket, Key key) const {
+        for (size_t i = 0; i < bucket_slots; ++i) {
+            if (slots[bucket * bucket_slots + i] == key) return true;
+        }
+        return false;
+    }
+
+    constexpr bool build(const std::array<Key, N>& keys) {
+        std::array<uint8_t, buckets> used{};
+        slots.fill(keys[0]);
+
+        for (size_t k = 0; k < N; ++k) {
+            Key current = keys[k];
+            size_t b1 = bucket_1(current), b2 = bucket_2(current);
+            size_t bucket = used[b1] <= used[b2] ? b1 : b2;
+
+            bool placed = false;
+            for (int kick = 0; kick <= max_kicks; ++kick) {
+                if (used[bucket] < bucket_slots) {
+                    slots[bucket * bucket_slots + used[bucket]++] = current;
+                    placed = true;
+                    break;
+                }
+                // bucket is full, evict a resident (rotating through the slots) into its other bucket
+                Key evicted = slots[bucket * bucket_slots + (kick + k) % bucket_slots];
+                slots[bucket * bucket_slots + (kick + k) % bucket_slots] = current;
+                current = evicted;
+                size_t alt_1 = bucket_1(current);
+                bucket = alt_1 == bucket ? bucket_2(current) : alt_1;
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+
+    std::array<Key, buckets * bucket_slots> slots{};
+    uint64_t seed_1{0};
+    uint64_t seed_2{0};
+};
+
+template <typename Key, size_t N>
+constexpr StaticCuckooSet<Key, N> make_static_cuckoo_set(const Key (&keys)[N]) {
+    std::array<Key, N> array{};
+    for (size_t i = 0; i < N; ++i) array[i] = keys[i];
+    return StaticCuckooSet<Key, N>(array);
+}
+
+#endif
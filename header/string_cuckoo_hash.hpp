@@ -0,0 +1,116 @@
+#ifndef STRING_CUCKOO_HASH
+#define STRING_CUCKOO_HASH
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Cuckoo set of variable-length string keys.
+//
+// Key bytes live once, appended to an arena; the table itself only holds fixed-size entries of a 32-bit
+// fingerprint, the key length and the key's offset into the arena. A probe compares fingerprints and
+// lengths first and touches the key bytes only when both match, and an eviction chain moves entries,
+// never key bytes.
+//
+// The layout is LocalCuckooHash's: 4-entry buckets in page-sized windows, the alternate bucket being the
+// first one XORed with a tag. Here the tag comes from the stored fingerprint, so a kicked entry finds
+// its other bucket without rehashing its key.
+//
+// Lookups take std::string_view, so std::string and string literals are probed without allocating.
+class StringCuckooHash {
+public:
+    struct Entry {
+        // 0 marks an empty entry, real fingerprints are never 0
+        uint32_t fingerprint;
+        uint32_t length;
+        uint64_t offset;
+    };
+
+    static constexpr size_t page_bytes = 4096;
+    static constexpr size_t bucket_slots = 4;
+    static constexpr size_t window_buckets = page_bytes / (bucket_slots * sizeof(Entry));
+    static_assert((window_buckets & (window_buckets - 1)) == 0, "window must be a power of two");
+
+    // same starting capacity and growth ladder as CuckooHash(size_index), grows past max_load
+    explicit StringCuckooHash(int size_index = 0, uint64_t seed = std::random_device{}(), float max_load = 0.75);
+
+    void insert(std::string_view key);
+    // 1 if key is in its first bucket, 2 if in its alternate, -1 if absent
+    int contains(std::string_view key) const;
+    // the stored copy of key, valid until the next insert or erase
+    std::optional<std::string_view> find(std::string_view key) const;
+    bool erase(std::string_view key);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return entries.size(); }
+    float load_factor() const { return static_cast<float>(size_) / static_cast<float>(entries.size()); }
+    int times_rehashed() const { return times_rehashed_; }
+    // bytes held by the key store, erased keys included until the next compaction
+    size_t arena_bytes() const { return arena.size(); }
+
+private:
+    // page-aligned storage, so windows line up with pages
+    template <typename T>
+    struct PageAllocator {
+        using value_type = T;
+        PageAllocator() = default;
+        template <typename U>
+        PageAllocator(const PageAllocator<U>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{page_bytes})); }
+        void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t{page_bytes}); }
+
+        bool operator==(const PageAllocator&) const { return true; }
+    };
+
+    static constexpr int max_kicks = 500;
+
+    uint64_t hash(std::string_view key) const;
+
+    static uint32_t fingerprint(uint64_t h) {
+        uint32_t fp = static_cast<uint32_t>(h);
+        return fp == 0 ? 1 : fp;
+    }
+
+    size_t first_bucket(uint64_t h) const;
+
+    // never zero, so the two buckets always differ
+    static size_t tag(uint32_t fp) {
+        return 1 + (fp & 0xffff) % (window_buckets - 1);
+    }
+
+    static size_t alternate(size_t bucket, uint32_t fp) {
+        return bucket ^ tag(fp);
+    }
+
+    std::string_view key_of(const Entry& entry) const {
+        return {arena.data() + entry.offset, entry.length};
+    }
+
+    // the entry holding key, whose hash is h, or nullptr
+    const Entry* locate(std::string_view key, uint64_t h) const;
+
+    // places an entry whose first bucket is given, false if the eviction chain ran out with the homeless
+    // entry left in entry
+    bool place(Entry& entry, size_t bucket);
+    // rebuilds at the next rung of the ladder with a fresh seed and a compacted arena, then places pending
+    void grow(Entry pending);
+    // drops the bytes of erased keys, entries stay where they are
+    void compact();
+
+    std::vector<Entry, PageAllocator<Entry>> entries;
+    std::vector<char> arena;
+    size_t dead_bytes{0};
+    size_t size_index;
+    size_t size_{0};
+    float max_load;
+    uint64_t seed;
+    std::mt19937_64 generator;
+    int times_rehashed_{0};
+};
+
+#endif
@@ -1,60 +1,146 @@
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include "cuckoo_hash.hpp"
 
-void CuckooHash::insert(int key){
-    if (contains(key) == 1 || contains(key) == 2) return;
+namespace{
+    //a * b mod m by doubling, so no 128-bit type is needed. Only runs when the ladder is extended, so speed does not matter
+    uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m){
+        auto add_mod = [m](uint64_t x, uint64_t y){ return x >= m - y ? x - (m - y) : x + y; };
+        uint64_t result = 0;
+        a %= m;
+        while (b > 0){
+            if (b & 1) result = add_mod(result, a);
+            a = add_mod(a, a);
+            b >>= 1;
+        }
+        return result;
+    }
 
-    //Initialise variables
-    size_t hash = hash_1(key);
-    bool is_hash_1 = true;
-    int cuckoo{0}, counter{0}, last_key = key;
-    
-    //Run a loop where the check will alternatively check each vector to see if the hashed key value has a stored value in the bucket
-    //If a value is contained in the bucket, evict the value and then rehash the value into the other bucket
-    //Loop will continue to evict and rehash until a vacant bucket is found or the predefined max steps is reached and will then trigger a rehash.
-    while(counter < max_steps){
-        if (is_hash_1){
-            if (!(h1[hash].has_value())){
-                h1[hash] = key;
-                ++size_;
-                break;
-            } else{
-                cuckoo = last_key = h1[hash].value();
-                h1[hash] = key;
-                hash = hash_2(cuckoo);
-                is_hash_1 = false;
-            }
-        } else{
-            if (!(h2[hash].has_value())){
-                h2[hash] = cuckoo;
-                ++size_;
-                break;
-            } else{
-                key= last_key = h2[hash].value();
-                h2[hash] = cuckoo;
-                hash = hash_1(key);
-                is_hash_1 = true;
+    uint64_t pow_mod(uint64_t base, uint64_t exp, uint64_t m){
+        uint64_t result = 1;
+        base %= m;
+        while (exp > 0){
+            if (exp & 1) result = mul_mod(result, base, m);
+            base = mul_mod(base, base, m);
+            exp >>= 1;
+        }
+        return result;
+    }
+
+    //Deterministic Miller-Rabin, these witnesses are sufficient for every 64-bit n
+    bool is_prime(uint64_t n){
+        if (n < 2) return false;
+        for (uint64_t p : {2ull, 3ull, 5ull, 7ull, 11ull, 13ull, 17ull, 19ull, 23ull, 29ull, 31ull, 37ull}){
+            if (n % p == 0) return n == p;
+        }
+        uint64_t d = n - 1;
+        int r = 0;
+        while ((d & 1) == 0){
+            d >>= 1;
+            ++r;
+        }
+        for (uint64_t a : {2ull, 3ull, 5ull, 7ull, 11ull, 13ull, 17ull, 19ull, 23ull, 29ull, 31ull, 37ull}){
+            uint64_t x = pow_mod(a, d, n);
+            if (x == 1 || x == n - 1) continue;
+            bool composite = true;
+            for (int i = 1; i < r && composite; ++i){
+                x = mul_mod(x, x, n);
+                if (x == n - 1) composite = false;
             }
+            if (composite) return false;
+        }
+        return true;
+    }
+}
+
+template <typename Key>
+void BasicCuckooHash<Key>::insert(Key key){
+    if (contains(key) != -1) return;
+
+    //Each pass either places key or rebuilds the table and goes round again with whichever key the failed
+    //chain left without a slot, so a run of rebuilds costs loop iterations rather than stack frames
+    while (true){
+        bool placed = place(key);
+
+        //An abnormally long eviction chain while still under the load threshold points at a bad hash pair
+        //(or crafted keys), so draw new hash parameters and rebuild in place rather than climbing the sizes ladder
+        if (!placed && load_factor() <= max_load && reseeds_at_capacity_ < max_reseeds && reseed()){
+            ++times_reseeded_;
+            ++reseeds_at_capacity_;
+            BasicCuckooHash::rehash(capacity_);
+            continue;
         }
-        ++counter;
+        if (load_factor() > max_load || !placed){
+            grow();
+            //If max steps case is triggered, the last key that was evicted does not get inserted when it toggles a rehash
+            //So attempt to reinsert the key again after rehash
+            if (!placed) continue;
+        }
+        return;
     }
-    if (load_factor() > max_load || counter == max_steps){
-        ++size_index;
-        ++times_rehashed_;
-        max_steps = 6 * static_cast<size_t>((std::ceil(log2(sizes[size_index]))));
-        if (size_index < sizes.size()) {
-            rehash(sizes[size_index]);
-        } else{
-            throw std::runtime_error(&"Exceeded maximum size of hash table" [ sizes[sizes.size() - 1]]);
+}
+
+template <typename Key>
+typename BasicCuckooHash<Key>::insert_result BasicCuckooHash<Key>::try_insert(Key key){
+    if (contains(key) != -1) return insert_result::already_present;
+    if (static_cast<float>(size_ + 1) > max_load * static_cast<float>(capacity())) return insert_result::needs_growth;
+
+    if (place(key)) return insert_result::inserted;
+    //Put every key on the failed chain back where it was, key ends up holding the original key again
+    unwind(key);
+    return insert_result::needs_growth;
+}
+
+template <typename Key>
+void BasicCuckooHash<Key>::grow(){
+    rehash(next_capacity());
+}
+
+template <typename Key>
+size_t BasicCuckooHash<Key>::next_capacity(){
+    ++size_index;
+    reseeds_at_capacity_ = 0;
+    ++times_rehashed_;
+    size_t new_size = capacity_for(size_index);
+    max_steps = 6 * static_cast<size_t>((std::ceil(log2(new_size))));
+    return new_size;
+}
+
+//Run a loop where the check will alternatively check each vector to see if the hashed key value has a stored value in the bucket
+//If a value is contained in the bucket, evict the value and then rehash the value into the other bucket
+//Loop will continue to evict and rehash until a vacant bucket is found or the predefined max steps is reached.
+template <typename Key>
+bool BasicCuckooHash<Key>::place(Key& key){
+    size_t hash = hash_1(key);
+    for (size_t step = 0; step < max_steps; ++step){
+        bool is_hash_1 = step % 2 == 0;
+        std::optional<Key>& slot = is_hash_1 ? h1[hash] : h2[hash];
+        if (!slot.has_value()){
+            slot = key;
+            mark(is_hash_1 ? hash : capacity_ + hash);
+            ++size_;
+            return true;
         }
-        //If max steps case is triggered, the last key that was evicted does not get inserted when it toggles a rehash
-        //So attempt to reinsert the key again after rehash
-        insert(last_key);
+        std::swap(key, *slot);
+        hash = is_hash_1 ? hash_2(key) : hash_1(key);
+    }
+    return false;
+}
+
+//Every step of a failed chain swapped the key in hand with the occupant of its slot, so swapping back in reverse order
+//undoes it. The evicted key always sat at its own hash in that array, so the slots can be recomputed instead of recorded.
+template <typename Key>
+void BasicCuckooHash<Key>::unwind(Key& key){
+    for (size_t step = max_steps; step-- > 0;){
+        if (step % 2 == 0) std::swap(key, *h1[hash_1(key)]);
+        else std::swap(key, *h2[hash_2(key)]);
     }
 }
 
 //Contains returns the int of which bucket the value belongs in for check in erase method and it returns -1 if it does not belong to a bucket.
-int CuckooHash::contains(int key){
+template <typename Key>
+int BasicCuckooHash<Key>::contains(Key key){
     //Hash both key for both vectors.
     size_t key_1 = hash_1(key);
     size_t key_2 = hash_2(key);
@@ -69,7 +155,8 @@ int CuckooHash::contains(int key){
 }
 
 //Find checks if a given key is in the hashtable
-std::optional<int> CuckooHash::find(int key){
+template <typename Key>
+std::optional<Key> BasicCuckooHash<Key>::find(Key key){
     size_t key_1 = hash_1(key);
     size_t key_2 = hash_2(key);
 
@@ -83,7 +170,8 @@ std::optional<int> CuckooHash::find(int key){
 }
 
 
-bool CuckooHash::erase(int key){
+template <typename Key>
+bool BasicCuckooHash<Key>::erase(Key key){
     //Hash both key for both vectors.
     size_t key_1 = hash_1(key);
     size_t key_2 = hash_2(key);
@@ -92,88 +180,207 @@ bool CuckooHash::erase(int key){
     //Check if value is in vec h1 and resets to default std::optional<int>
     if (bucket == 1){
         h1[key_1].reset();
+        unmark(key_1);
         --size_;
         return true;
     } 
     // Check if value is in vec h2 and resets to default std::optional<int>
     else if (bucket == 2){
         h2[key_2].reset();
+        unmark(capacity_ + key_2);
         --size_;
         return true;
     }
     return false;
 }
 
-//Helper methods
-void CuckooHash::rehash(size_t new_size){
+template <typename Key>
+void BasicCuckooHash<Key>::contains_batch(const Key* keys, size_t n, int* out){
+    constexpr size_t batch = 16;
+    size_t slot_1[batch], slot_2[batch];
 
-    //Create values vector to store all the values in the cuckoo hash table.
-    std::vector<int> values;
-    values.reserve((new_size));
-    for(size_t i = 0; i < h1.size(); ++i){
-        if (h1[i]) values.push_back(h1[i].value());
-        if (h2[i]) values.push_back(h2[i].value());
+    for (size_t start = 0; start < n; start += batch){
+        size_t count = std::min(batch, n - start);
+        for (size_t i = 0; i < count; ++i){
+            slot_1[i] = hash_1(keys[start + i]);
+            slot_2[i] = hash_2(keys[start + i]);
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(&h1[slot_1[i]]);
+            __builtin_prefetch(&h2[slot_2[i]]);
+#endif
+        }
+        for (size_t i = 0; i < count; ++i){
+            Key key = keys[start + i];
+            if (h1[slot_1[i]] && *h1[slot_1[i]] == key) out[start + i] = 1;
+            else if (h2[slot_2[i]] && *h2[slot_2[i]] == key) out[start + i] = 2;
+            else out[start + i] = -1;
+        }
     }
+}
 
-    capacity_ = new_size;
-    size_ = 0;
+//Helper methods
+template <typename Key>
+void BasicCuckooHash<Key>::rehash(size_t new_size){
+    //Allocate the new arrays from the same memory resource and swap them in. The old arrays stay untouched
+    //as the source of keys, so a rebuild that fails part way can start over from them without a key copy.
+    slot_array old_h1(new_size, h1.get_allocator());
+    slot_array old_h2(new_size, h2.get_allocator());
+    std::pmr::vector<uint64_t> old_occupied(bitmap_words(new_size), 0, occupied.get_allocator());
+    old_h1.swap(h1);
+    old_h2.swap(h2);
+    old_occupied.swap(occupied);
+    size_t old_capacity = capacity_;
+    size_t count = size_;
+
+    //Place every key with the new size (the new size will change the hash location). A failed chain reseeds at this
+    //capacity or moves up the sizes ladder and starts over inside this loop, so rebuilds never nest through insert.
+    while (true){
+        capacity_ = new_size;
+        size_ = 0;
+
+        bool placed = true;
+        for (size_t word = 0; placed && word < old_occupied.size(); ++word){
+            uint64_t bits = old_occupied[word];
+            while (bits != 0){
+                size_t bit = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                //place() swaps evicted keys through its argument, so hand it a copy and leave the source intact
+                Key key = *(bit < old_capacity ? old_h1[bit] : old_h2[bit - old_capacity]);
+                if (!place(key)){
+                    placed = false;
+                    break;
+                }
+            }
+        }
+        if (placed) return;
+
+        float load = static_cast<float>(count) / static_cast<float>(2 * new_size);
+        if (load <= max_load && reseeds_at_capacity_ < max_reseeds && reseed()){
+            ++times_reseeded_;
+            ++reseeds_at_capacity_;
+            //Same size, so clear the partly built arrays where they are
+            std::fill(h1.begin(), h1.end(), std::nullopt);
+            std::fill(h2.begin(), h2.end(), std::nullopt);
+            std::fill(occupied.begin(), occupied.end(), 0);
+            continue;
+        }
+        new_size = next_capacity();
+        slot_array fresh_h1(new_size, h1.get_allocator());
+        slot_array fresh_h2(new_size, h2.get_allocator());
+        std::pmr::vector<uint64_t> fresh_occupied(bitmap_words(new_size), 0, occupied.get_allocator());
+        fresh_h1.swap(h1);
+        fresh_h2.swap(h2);
+        fresh_occupied.swap(occupied);
+    }
+}
 
-    h1.assign(capacity_, std::nullopt);
-    h2.assign(capacity_, std::nullopt);
+//Fixed hash functions have nothing to reseed, so chain blowups always grow the table
+template <typename Key>
+bool BasicCuckooHash<Key>::reseed(){
+    return false;
+}
 
-    //Re-insert values into the newly sized hash table as the new size will change the hash location.
-    for (int x : values){
-        insert(x);
+template <typename Key>
+BasicFrozenCuckooHash<Key> BasicCuckooHash<Key>::freeze() const{
+    std::vector<Key> keys;
+    keys.reserve(size_);
+    for(size_t i = 0; i < h1.size(); ++i){
+        if (h1[i]) keys.push_back(h1[i].value());
+        if (h2[i]) keys.push_back(h2[i].value());
     }
+    return BasicFrozenCuckooHash<Key>(keys);
 }
 
-void CuckooHash::clear(){
+template <typename Key>
+void BasicCuckooHash<Key>::clear(){
     h1.clear();
     h2.clear();
+    occupied.clear();
     size_ = 0;
 }
 
-bool CuckooHash::empty() const{
+template <typename Key>
+bool BasicCuckooHash<Key>::empty() const{
     return size_ == 0;
 }
 
-size_t CuckooHash::size() const{
+template <typename Key>
+size_t BasicCuckooHash<Key>::size() const{
     return size_;
 }
 
 // Multiply by 2, as capacity_ tracks the capacity per array
-size_t CuckooHash::capacity() const{
+template <typename Key>
+size_t BasicCuckooHash<Key>::capacity() const{
     return 2 * capacity_;
 }
 
-int CuckooHash::times_rehashed() const {
+template <typename Key>
+int BasicCuckooHash<Key>::times_rehashed() const {
     return times_rehashed_;
 }
 
-float CuckooHash::load_factor() const{
+template <typename Key>
+int BasicCuckooHash<Key>::times_reseeded() const {
+    return times_reseeded_;
+}
+
+template <typename Key>
+float BasicCuckooHash<Key>::load_factor() const{
     return static_cast<float>(size_) / static_cast<float>(capacity());
 }
 
-const std::vector<std::optional<int>>& CuckooHash::h1_bucket() const{
+template <typename Key>
+const typename BasicCuckooHash<Key>::slot_array& BasicCuckooHash<Key>::h1_bucket() const{
     return h1;
 }
 
-const std::vector<std::optional<int>>& CuckooHash::h2_bucket() const{
+template <typename Key>
+const typename BasicCuckooHash<Key>::slot_array& BasicCuckooHash<Key>::h2_bucket() const{
     return h2;
 }
 
-size_t CuckooHash::get_hash_1(int key){
+template <typename Key>
+std::pmr::memory_resource* BasicCuckooHash<Key>::resource() const{
+    return h1.get_allocator().resource();
+}
+
+template <typename Key>
+size_t BasicCuckooHash<Key>::get_hash_1(Key key){
     return hash_1(key);
 }
 
-size_t CuckooHash::get_hash_2(int key){
+template <typename Key>
+size_t BasicCuckooHash<Key>::get_hash_2(Key key){
     return hash_2(key);
 }
 
+//Past the end of the sizes ladder keep doubling, rounding up to the next prime so the modulo still spreads keys well
+template <typename Key>
+size_t BasicCuckooHash<Key>::capacity_for(size_t size_index){
+    if (size_index < sizes.size()) return sizes[size_index];
+
+    size_t capacity = sizes.back();
+    for (size_t i = sizes.size() - 1; i < size_index; ++i){
+        if (capacity > SIZE_MAX / 4) throw std::length_error("Exceeded maximum size of hash table");
+        capacity = 2 * capacity + 1;
+        while (!is_prime(capacity)) capacity += 2;
+    }
+    return capacity;
+}
+
 //Basic hash functions to be overloaded Randomised child class for randomised approach implementation.
-size_t CuckooHash::hash_1(int key){
-    return (7 * (key + 3)) % capacity_;
+//64-bit keys use unsigned arithmetic so keys near the limits wrap instead of overflowing.
+template <typename Key>
+size_t BasicCuckooHash<Key>::hash_1(Key key){
+    if constexpr (sizeof(Key) > sizeof(int)) return (7 * (static_cast<uint64_t>(key) + 3)) % capacity_;
+    else return (7 * (key + 3)) % capacity_;
+}
+template <typename Key>
+size_t BasicCuckooHash<Key>::hash_2(Key key){
+    if constexpr (sizeof(Key) > sizeof(int)) return (5 * (static_cast<uint64_t>(key) + 1)) % capacity_;
+    else return (5 * (key + 1)) % capacity_;
 }
-size_t CuckooHash::hash_2(int key){
-    return (5 * (key + 1)) % capacity_;
-}
\ No newline at end of file
+
+template class BasicCuckooHash<int>;
+template class BasicCuckooHash<int64_t>;
@@ -0,0 +1,150 @@
+#include "frozen_cuckoo_hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    // seeds tried at one capacity before the load target is relaxed
+    constexpr int seeds_per_capacity = 16;
+    // capacity relaxations before giving up, 64 steps of 5% end below a tenth of the requested load
+    constexpr int max_relaxations = 64;
+    // evictions allowed for a single key before the seed pair is rejected
+    constexpr int max_kicks = 500;
+
+    constexpr uint64_t image_magic = 0x4672437563636f31ull;
+
+    struct ImageHeader {
+        uint64_t magic;
+        uint64_t key_size;
+        uint64_t size;
+        uint64_t buckets;
+        uint64_t seed_1;
+        uint64_t seed_2;
+    };
+}
+
+template <typename Key>
+BasicFrozenCuckooHash<Key>::BasicFrozenCuckooHash(const std::vector<Key>& keys, double max_load) {
+    // a key repeated more than 2 * bucket_slots times can never be placed, so duplicates are dropped first.
+    // Strictly increasing input, as cuckoo_tool produces, is already distinct and skips the sort
+    std::vector<Key> distinct;
+    const std::vector<Key>* input = &keys;
+    if (std::adjacent_find(keys.begin(), keys.end(), std::greater_equal<Key>()) != keys.end()) {
+        distinct = keys;
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        input = &distinct;
+    }
+
+    size_ = input->size();
+    if (input->empty()) return;
+
+    // fixed generator seed, so freezing the same keys always yields the same layout
+    std::mt19937_64 generator(0x5eed5eed5eed5eedull);
+    buckets = static_cast<size_t>(std::ceil(static_cast<double>(input->size()) / (bucket_slots * max_load)));
+
+    for (int relaxation = 0; relaxation < max_relaxations; ++relaxation) {
+        for (int attempt = 0; attempt < seeds_per_capacity; ++attempt) {
+            seed_1 = generator();
+            seed_2 = generator();
+            ++seed_attempts_;
+            if (build(*input)) return;
+        }
+        // no seed pair worked at this load, give up 5% of the density and search again
+        buckets += buckets / 20 + 1;
+    }
+    throw std::runtime_error("Could not place the keys in a frozen table");
+}
+
+template <typename Key>
+bool BasicFrozenCuckooHash<Key>::build(const std::vector<Key>& keys) {
+    // every empty slot holds a real key, so a probe can never match a key that was not inserted
+    slots.assign(buckets * bucket_slots, keys[0]);
+    std::vector<uint8_t> used(buckets, 0);
+    std::minstd_rand kick_choice(static_cast<uint32_t>(seed_1));
+
+    for (Key key : keys) {
+        Key current = key;
+        size_t b1 = bucket_1(current), b2 = bucket_2(current);
+        size_t bucket = used[b1] <= used[b2] ? b1 : b2;
+
+        bool placed = false;
+        for (int kick = 0; kick <= max_kicks; ++kick) {
+            if (used[bucket] < bucket_slots) {
+                slots[bucket * bucket_slots + used[bucket]++] = current;
+                placed = true;
+                break;
+            }
+            // bucket is full, evict a random resident and move it to its other bucket
+            std::swap(current, slots[bucket * bucket_slots + kick_choice() % bucket_slots]);
+            size_t alt_1 = bucket_1(current);
+            bucket = alt_1 == bucket ? bucket_2(current) : alt_1;
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
+
+template <typename Key>
+float BasicFrozenCuckooHash<Key>::load_factor() const {
+    if (slots.empty()) return 0.0f;
+    return static_cast<float>(size_) / static_cast<float>(slots.size());
+}
+
+template <typename Key>
+void BasicFrozenCuckooHash<Key>::save(std::ostream& out) const {
+    ImageHeader header{image_magic, sizeof(Key), size_, buckets, seed_1, seed_2};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Key)));
+    if (!out) throw std::runtime_error("Failed to write frozen table");
+}
+
+template <typename Key>
+BasicFrozenCuckooHash<Key> BasicFrozenCuckooHash<Key>::load(std::istream& in) {
+    ImageHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != image_magic || header.key_size != sizeof(Key)) {
+        throw std::runtime_error("Not a frozen table image for this key width");
+    }
+
+    // the header comes from a file, so check it describes a table the rest of the image can hold before allocating
+    constexpr uint64_t max_buckets = std::numeric_limits<uint64_t>::max() / (bucket_slots * sizeof(Key));
+    if (header.buckets > max_buckets || header.size > header.buckets * bucket_slots || (header.size == 0) != (header.buckets == 0)) {
+        throw std::runtime_error("Corrupt frozen table image");
+    }
+    uint64_t slot_bytes = header.buckets * bucket_slots * sizeof(Key);
+    std::streampos here = in.tellg();
+    if (here != std::streampos(-1)) {
+        in.seekg(0, std::ios::end);
+        std::streampos end = in.tellg();
+        in.seekg(here);
+        if (end == std::streampos(-1) || static_cast<uint64_t>(end - here) < slot_bytes) {
+            throw std::runtime_error("Truncated frozen table image");
+        }
+    }
+
+    BasicFrozenCuckooHash table;
+    table.size_ = header.size;
+    table.buckets = header.buckets;
+    table.seed_1 = header.seed_1;
+    table.seed_2 = header.seed_2;
+    // unseekable streams (pipes) have no length to check, so the slots are read a chunk at a time and a
+    // truncated image fails after allocating no more than it actually held
+    constexpr size_t chunk_slots = size_t{1} << 20;
+    size_t total = header.buckets * bucket_slots;
+    while (table.slots.size() < total) {
+        size_t at = table.slots.size();
+        size_t count = std::min(chunk_slots, total - at);
+        table.slots.resize(at + count);
+        in.read(reinterpret_cast<char*>(table.slots.data() + at), static_cast<std::streamsize>(count * sizeof(Key)));
+        if (!in) throw std::runtime_error("Truncated frozen table image");
+    }
+    return table;
+}
+
+template class BasicFrozenCuckooHash<int>;
+template class BasicFrozenCuckooHash<int64_t>;
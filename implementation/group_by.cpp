@@ -0,0 +1,218 @@
+#include "group_by.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    uint64_t splitmix(uint64_t& state) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t random_seed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+}
+
+template <typename Key>
+BasicAccumulatorMap<Key>::BasicAccumulatorMap(size_t expected_keys)
+    // random seed, so crafted keys cannot pile into the same buckets
+    : BasicAccumulatorMap(expected_keys, random_seed()) {}
+
+template <typename Key>
+BasicAccumulatorMap<Key>::BasicAccumulatorMap(size_t expected_keys, uint64_t seed) : kick_state(seed) {
+    this->seed = splitmix(kick_state);
+
+    size_t initial = static_cast<size_t>(std::ceil(static_cast<double>(expected_keys) / (bucket_slots * max_load)));
+    buckets.resize(std::max<size_t>(1, initial));
+}
+
+template <typename Key>
+Accumulator* BasicAccumulatorMap<Key>::probe(Key key, uint64_t hash) {
+    Bucket& first = buckets[bucket_1(hash)];
+    for (uint8_t i = 0; i < first.used; ++i) {
+        if (first.keys[i] == key) return &first.accumulators[i];
+    }
+    Bucket& second = buckets[bucket_2(hash)];
+    for (uint8_t i = 0; i < second.used; ++i) {
+        if (second.keys[i] == key) return &second.accumulators[i];
+    }
+    return nullptr;
+}
+
+template <typename Key>
+const Accumulator* BasicAccumulatorMap<Key>::find(Key key) const {
+    return const_cast<BasicAccumulatorMap*>(this)->probe(key, hash(key));
+}
+
+template <typename Key>
+Accumulator& BasicAccumulatorMap<Key>::upsert(Key key, uint64_t key_hash) {
+    //Hot path: an existing group is updated where it sits
+    if (Accumulator* existing = probe(key, key_hash)) return *existing;
+
+    if (static_cast<double>(size_ + 1) > max_load * static_cast<double>(capacity())) rehash(2 * buckets.size());
+    ++size_;
+
+    //Common miss path: a free slot in one of the two buckets, no eviction needed
+    Bucket& first = buckets[bucket_1(key_hash)];
+    Bucket& second = buckets[bucket_2(key_hash)];
+    Bucket& target = first.used <= second.used ? first : second;
+    if (target.used < bucket_slots) {
+        target.keys[target.used] = key;
+        target.accumulators[target.used] = Accumulator{};
+        return target.accumulators[target.used++];
+    }
+
+    //Both buckets full: run the eviction chain, growing if it fails, then look the new key up again
+    Key homeless = key;
+    Accumulator acc{};
+    while (!place(homeless, acc)) rehash(2 * buckets.size());
+    return *probe(key, key_hash);
+}
+
+template <typename Key>
+bool BasicAccumulatorMap<Key>::place(Key& key, Accumulator& acc) {
+    uint64_t key_hash = hash(key);
+    size_t b1 = bucket_1(key_hash), b2 = bucket_2(key_hash);
+    size_t b = buckets[b1].used <= buckets[b2].used ? b1 : b2;
+
+    for (int kick = 0; kick <= max_kicks; ++kick) {
+        Bucket& bucket = buckets[b];
+        if (bucket.used < bucket_slots) {
+            bucket.keys[bucket.used] = key;
+            bucket.accumulators[bucket.used] = acc;
+            ++bucket.used;
+            return true;
+        }
+        // evict a random resident and carry it to its other bucket
+        size_t slot = splitmix(kick_state) % bucket_slots;
+        std::swap(key, bucket.keys[slot]);
+        std::swap(acc, bucket.accumulators[slot]);
+        key_hash = hash(key);
+        size_t alt = bucket_1(key_hash);
+        b = alt == b ? bucket_2(key_hash) : alt;
+    }
+    return false;
+}
+
+template <typename Key>
+void BasicAccumulatorMap<Key>::rehash(size_t new_buckets) {
+    //Re-place straight from the old buckets, which stay intact until the rebuild succeeds
+    std::vector<Bucket> old(new_buckets);
+    old.swap(buckets);
+    ++times_rehashed_;
+
+    //A failed chain while rebuilding gets a little more room and starts over. The seed never changes,
+    //so hashes computed before the rehash (e.g. by a prefetching batch) stay valid.
+    while (true) {
+        bool placed_all = true;
+        for (const Bucket& bucket : old) {
+            for (uint8_t i = 0; i < bucket.used && placed_all; ++i) {
+                Key key = bucket.keys[i];
+                Accumulator acc = bucket.accumulators[i];
+                placed_all = place(key, acc);
+            }
+            if (!placed_all) break;
+        }
+        if (placed_all) return;
+        new_buckets += new_buckets / 8 + 1;
+        buckets.assign(new_buckets, Bucket{});
+    }
+}
+
+template <typename Key>
+void BasicAccumulatorMap<Key>::merge(const BasicAccumulatorMap& other) {
+    other.for_each([this](Key key, const Accumulator& acc) { upsert(key).merge(acc); });
+}
+
+template <typename Key>
+float BasicAccumulatorMap<Key>::load_factor() const {
+    return static_cast<float>(size_) / static_cast<float>(capacity());
+}
+
+template <typename Key>
+BasicGroupBy<Key>::BasicGroupBy(unsigned threads, size_t partitions)
+    : threads(std::max(1u, threads)), seed_state(random_seed()) {
+    // a few partitions per thread keeps the combine balanced when some keys are much hotter than others,
+    // a single thread has nothing to combine and skips partitioning altogether
+    if (partitions == 0) partitions = this->threads == 1 ? 1 : 4 * static_cast<size_t>(this->threads);
+    result.reserve(partitions);
+    for (size_t p = 0; p < partitions; ++p) result.emplace_back(0, splitmix(seed_state));
+}
+
+template <typename Key>
+void BasicGroupBy<Key>::run(const std::vector<Key>& keys, const std::vector<int64_t>& values) {
+    if (keys.size() != values.size()) throw std::invalid_argument("GroupBy::run needs one value per key");
+    size_t partitions = result.size();
+    std::vector<std::vector<BasicAccumulatorMap<Key>>> local(threads);
+    for (auto& maps : local) {
+        maps.reserve(partitions);
+        for (size_t p = 0; p < partitions; ++p) maps.emplace_back(0, splitmix(seed_state));
+    }
+    size_t chunk = (keys.size() + threads - 1) / threads;
+
+    auto aggregate = [&](unsigned t) {
+        size_t begin = std::min(keys.size(), t * chunk);
+        size_t end = std::min(keys.size(), begin + chunk);
+        // hash and prefetch a batch of rows first so their bucket misses overlap instead of stalling one by one
+        constexpr size_t batch = 16;
+        size_t part[batch];
+        uint64_t hashes[batch];
+        for (size_t i = begin; i < end; i += batch) {
+            size_t n = std::min(batch, end - i);
+            for (size_t j = 0; j < n; ++j) {
+                part[j] = partitionOf(keys[i + j]);
+                hashes[j] = local[t][part[j]].hash(keys[i + j]);
+                local[t][part[j]].prefetch(hashes[j]);
+            }
+            for (size_t j = 0; j < n; ++j) {
+                local[t][part[j]].upsert(keys[i + j], hashes[j]).add(values[i + j]);
+            }
+        }
+    };
+
+    // partition p only ever sees keys of partition p, so threads combine disjoint maps without locks
+    auto combine = [&](unsigned t) {
+        for (size_t p = t; p < partitions; p += threads) {
+            for (unsigned u = 0; u < threads; ++u) {
+                if (result[p].size() == 0) std::swap(result[p], local[u][p]);
+                else result[p].merge(local[u][p]);
+            }
+        }
+    };
+
+    auto parallel = [&](auto&& stage) {
+        if (threads == 1) {
+            stage(0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(stage, t);
+        for (auto& worker : workers) worker.join();
+    };
+
+    parallel(aggregate);
+    parallel(combine);
+}
+
+template <typename Key>
+const Accumulator* BasicGroupBy<Key>::find(Key key) const {
+    return result[partitionOf(key)].find(key);
+}
+
+template <typename Key>
+size_t BasicGroupBy<Key>::size() const {
+    size_t total = 0;
+    for (const auto& map : result) total += map.size();
+    return total;
+}
+
+template class BasicAccumulatorMap<int>;
+template class BasicAccumulatorMap<int64_t>;
+template class BasicGroupBy<int>;
+template class BasicGroupBy<int64_t>;
@@ -0,0 +1,136 @@
+#include "hash_join.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+template <typename Key>
+BasicHashJoin<Key>::BasicHashJoin(const std::vector<Key>& build_column) {
+    if (build_column.size() > UINT32_MAX) throw std::length_error("Build side exceeds 32-bit row ids");
+
+    // bulk load the distinct keys in one go instead of inserting row by row
+    std::vector<Key> distinct(build_column);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    table = BasicFrozenCuckooHash<Key>(distinct);
+
+    // resolve every row's slot once, prefetching a batch ahead like the probe does. The table has more slots
+    // than rows (about n / 0.95), so near the row limit slot numbers no longer fit in 32 bits
+    std::vector<size_t> row_slot(build_column.size());
+    for (size_t i = 0; i < build_column.size(); i += batch_size) {
+        size_t batch = std::min(batch_size, build_column.size() - i);
+        for (size_t j = 0; j < batch; ++j) table.prefetch(build_column[i + j]);
+        for (size_t j = 0; j < batch; ++j) row_slot[i + j] = static_cast<size_t>(table.slot_of(build_column[i + j]));
+    }
+
+    groups.assign(table.capacity(), Group{0, 0});
+    for (size_t slot : row_slot) ++groups[slot].count;
+
+    // begin first points one past each group, then the reverse scatter walks it back to the start
+    uint32_t offset = 0;
+    for (Group& group : groups) {
+        offset += group.count;
+        group.begin = offset;
+        max_group = std::max<size_t>(max_group, group.count);
+    }
+
+    rows.resize(build_column.size());
+    for (size_t r = build_column.size(); r-- > 0;) {
+        rows[--groups[row_slot[r]].begin] = static_cast<row_id>(r);
+    }
+}
+
+template <typename Key>
+size_t BasicHashJoin<Key>::probe(const Key* probe_column, size_t n, row_id first_row,
+                                 row_id* out_build, row_id* out_probe, size_t out_capacity, size_t* rows_consumed) const {
+    size_t written = 0;
+    ptrdiff_t slots[batch_size];
+
+    for (size_t i = 0; i < n; i += batch_size) {
+        size_t batch = std::min(batch_size, n - i);
+
+        // stage 1: start loading every candidate bucket of the batch
+        for (size_t j = 0; j < batch; ++j) table.prefetch(probe_column[i + j]);
+
+        // stage 2: resolve slots, then start loading the matching groups
+        for (size_t j = 0; j < batch; ++j) {
+            slots[j] = table.slot_of(probe_column[i + j]);
+#if defined(__GNUC__) || defined(__clang__)
+            if (slots[j] >= 0) __builtin_prefetch(&groups[slots[j]]);
+#endif
+        }
+
+        // stage 3: emit pairs
+        for (size_t j = 0; j < batch; ++j) {
+            if (slots[j] < 0) continue;
+            const Group& group = groups[slots[j]];
+            if (written + group.count > out_capacity) {
+                *rows_consumed = i + j;
+                return written;
+            }
+            for (uint32_t r = 0; r < group.count; ++r) {
+                out_build[written] = rows[group.begin + r];
+                out_probe[written] = first_row + static_cast<row_id>(i + j);
+                ++written;
+            }
+        }
+    }
+
+    *rows_consumed = n;
+    return written;
+}
+
+template <typename Key>
+void BasicHashJoin<Key>::probePartition(const std::vector<Key>& probe_column, size_t begin, size_t end, Partition& out) const {
+    // output grows geometrically, always leaving room for the largest group so every call makes progress
+    size_t used = 0;
+    size_t reserve = std::max<size_t>(4096, 2 * max_group);
+    out.build_rows.resize(reserve);
+    out.probe_rows.resize(reserve);
+
+    while (begin < end) {
+        if (out.build_rows.size() - used < std::max<size_t>(max_group, 1)) {
+            out.build_rows.resize(2 * out.build_rows.size());
+            out.probe_rows.resize(2 * out.probe_rows.size());
+        }
+        size_t consumed = 0;
+        used += probe(probe_column.data() + begin, end - begin, static_cast<row_id>(begin),
+                      out.build_rows.data() + used, out.probe_rows.data() + used,
+                      out.build_rows.size() - used, &consumed);
+        if (begin + consumed < end) {
+            out.build_rows.resize(2 * out.build_rows.size());
+            out.probe_rows.resize(2 * out.probe_rows.size());
+        }
+        begin += consumed;
+    }
+
+    out.build_rows.resize(used);
+    out.probe_rows.resize(used);
+}
+
+template <typename Key>
+std::vector<typename BasicHashJoin<Key>::Partition> BasicHashJoin<Key>::join(const std::vector<Key>& probe_column, unsigned threads) const {
+    if (probe_column.size() > UINT32_MAX) throw std::length_error("Probe side exceeds 32-bit row ids");
+    threads = std::max(1u, threads);
+
+    std::vector<Partition> partitions(threads);
+    size_t chunk = (probe_column.size() + threads - 1) / threads;
+
+    if (threads == 1) {
+        probePartition(probe_column, 0, probe_column.size(), partitions[0]);
+        return partitions;
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = std::min(probe_column.size(), t * chunk);
+        size_t end = std::min(probe_column.size(), begin + chunk);
+        workers.emplace_back([this, &probe_column, begin, end, &partitions, t] {
+            probePartition(probe_column, begin, end, partitions[t]);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return partitions;
+}
+
+template class BasicHashJoin<int>;
+template class BasicHashJoin<int64_t>;
@@ -0,0 +1,60 @@
+#include "huge_page_resource.hpp"
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define CUCKOO_HAVE_MMAP 1
+#endif
+
+size_t HugePageResource::mapped_bytes() const {
+    return mapped;
+}
+
+void* HugePageResource::do_allocate(size_t bytes, size_t alignment) {
+#ifdef CUCKOO_HAVE_MMAP
+    if (bytes >= min_mapping && alignment <= huge_page_size) {
+        size_t length = roundUp(bytes);
+
+        // over-map by one huge page so the start can be aligned, then give back the slack
+        size_t padded = length + huge_page_size;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + huge_page_size - 1) & ~(uintptr_t{huge_page_size} - 1);
+        size_t head = aligned - start;
+        size_t tail = padded - head - length;
+        if (head > 0) munmap(raw, head);
+        if (tail > 0) munmap(reinterpret_cast<void*>(aligned + length), tail);
+
+        void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(p, length, MADV_HUGEPAGE);
+#endif
+        if (prefault) {
+            auto* bytes_ptr = static_cast<volatile unsigned char*>(p);
+            for (size_t offset = 0; offset < length; offset += huge_page_size) bytes_ptr[offset] = 0;
+        }
+
+        mapped += length;
+        return p;
+    }
+#endif
+    return upstream->allocate(bytes, alignment);
+}
+
+void HugePageResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+#ifdef CUCKOO_HAVE_MMAP
+    if (bytes >= min_mapping && alignment <= huge_page_size) {
+        munmap(p, roundUp(bytes));
+        mapped -= roundUp(bytes);
+        return;
+    }
+#endif
+    upstream->deallocate(p, bytes, alignment);
+}
+
+bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
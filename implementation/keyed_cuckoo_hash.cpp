@@ -0,0 +1,86 @@
+#include "keyed_cuckoo_hash.hpp"
+#include <random>
+
+namespace {
+    inline uint64_t rotl(uint64_t x, int b) {
+        return (x << b) | (x >> (64 - b));
+    }
+
+    inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    }
+}
+
+template <typename Key>
+uint64_t BasicKeyedCuckooHash<Key>::sipHash(uint64_t k0, uint64_t k1, uint64_t message) {
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ull;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dull;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ull;
+    uint64_t v3 = k1 ^ 0x7465646279746573ull;
+
+    // the whole message fits in one block, followed by the length-only final block
+    v3 ^= message;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= message;
+
+    const uint64_t last = uint64_t{8} << 56;
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) sipRound(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+template <typename Key>
+size_t BasicKeyedCuckooHash<Key>::hash_1(Key key) {
+    return sipHash(k1_0, k1_1, static_cast<uint64_t>(static_cast<int64_t>(key))) % this->capacity_;
+}
+
+template <typename Key>
+size_t BasicKeyedCuckooHash<Key>::hash_2(Key key) {
+    return sipHash(k2_0, k2_1, static_cast<uint64_t>(static_cast<int64_t>(key))) % this->capacity_;
+}
+
+template <typename Key>
+void BasicKeyedCuckooHash<Key>::genNewKeys() {
+    if (generator) {
+        k1_0 = (*generator)();
+        k1_1 = (*generator)();
+        k2_0 = (*generator)();
+        k2_1 = (*generator)();
+        return;
+    }
+
+    // a PRNG seeded from one 32-bit draw would leave only 2^32 possible keys to brute-force offline,
+    // so each 64-bit word takes two draws from the device and the keys get its full entropy
+    std::random_device device;
+    auto word = [&device]() { return (uint64_t{device()} << 32) | device(); };
+    k1_0 = word();
+    k1_1 = word();
+    k2_0 = word();
+    k2_1 = word();
+}
+
+template <typename Key>
+bool BasicKeyedCuckooHash<Key>::reseed() {
+    genNewKeys();
+    return true;
+}
+
+template <typename Key>
+void BasicKeyedCuckooHash<Key>::rehash(size_t new_size) {
+    genNewKeys();
+
+    BasicCuckooHash<Key>::rehash(new_size);
+}
+
+template class BasicKeyedCuckooHash<int>;
+template class BasicKeyedCuckooHash<int64_t>;
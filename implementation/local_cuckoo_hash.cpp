@@ -0,0 +1,138 @@
+#include "local_cuckoo_hash.hpp"
+#include "cuckoo_hash.hpp"
+#include <utility>
+
+namespace {
+    // whole windows only, so the XOR of any bucket with a tag stays inside the array
+    template <typename Key>
+    size_t slots_for(size_t size_index) {
+        constexpr size_t window = BasicLocalCuckooHash<Key>::window_slots;
+        size_t wanted = 2 * BasicCuckooHash<Key>::capacity_for(size_index);
+        return (wanted + window - 1) / window * window;
+    }
+}
+
+template <typename Key>
+BasicLocalCuckooHash<Key>::BasicLocalCuckooHash(int size_index, uint64_t seed, float max_load)
+    : slots(slots_for<Key>(size_index)), size_index(size_index), max_load(max_load), generator(seed) {
+    this->seed = generator();
+}
+
+template <typename Key>
+void BasicLocalCuckooHash<Key>::insert(Key key) {
+    if (contains(key) != -1) return;
+
+    if (static_cast<float>(size_ + 1) > max_load * static_cast<float>(slots.size())) {
+        grow(key);
+        return;
+    }
+    if (place(key)) ++size_;
+    // the chain ran out, key now holds whichever key was left without a slot
+    else grow(key);
+}
+
+template <typename Key>
+size_t BasicLocalCuckooHash<Key>::find_in(size_t bucket, Key key) const {
+    const slot_type* base = &slots[bucket * bucket_slots];
+    for (size_t i = 0; i < bucket_slots; ++i) {
+        if (base[i] == key) return i;
+    }
+    return bucket_slots;
+}
+
+template <typename Key>
+size_t BasicLocalCuckooHash<Key>::empty_in(size_t bucket) const {
+    const slot_type* base = &slots[bucket * bucket_slots];
+    for (size_t i = 0; i < bucket_slots; ++i) {
+        if (!base[i]) return i;
+    }
+    return bucket_slots;
+}
+
+template <typename Key>
+int BasicLocalCuckooHash<Key>::contains(Key key) const {
+    uint64_t h = hash(key);
+    size_t bucket = first_bucket(h);
+    if (find_in(bucket, key) != bucket_slots) return 1;
+    if (find_in(alternate(bucket, h), key) != bucket_slots) return 2;
+    return -1;
+}
+
+template <typename Key>
+std::optional<Key> BasicLocalCuckooHash<Key>::find(Key key) const {
+    if (contains(key) == -1) return std::nullopt;
+    return key;
+}
+
+template <typename Key>
+bool BasicLocalCuckooHash<Key>::erase(Key key) {
+    uint64_t h = hash(key);
+    size_t bucket = first_bucket(h);
+    size_t i = find_in(bucket, key);
+    if (i == bucket_slots) {
+        bucket = alternate(bucket, h);
+        i = find_in(bucket, key);
+        if (i == bucket_slots) return false;
+    }
+    slots[bucket * bucket_slots + i].reset();
+    --size_;
+    return true;
+}
+
+template <typename Key>
+bool BasicLocalCuckooHash<Key>::place(Key& key) {
+    uint64_t h = hash(key);
+    size_t bucket = first_bucket(h);
+    size_t other = alternate(bucket, h);
+    for (size_t candidate : {bucket, other}) {
+        size_t i = empty_in(candidate);
+        if (i != bucket_slots) {
+            slots[candidate * bucket_slots + i] = key;
+            return true;
+        }
+    }
+
+    // both full: random walk, each kicked key moves to its other bucket in the same window
+    if (generator() & 1) bucket = other;
+    for (int kick = 0; kick < max_kicks; ++kick) {
+        std::swap(key, *slots[bucket * bucket_slots + generator() % bucket_slots]);
+        bucket = alternate(bucket, hash(key));
+        size_t i = empty_in(bucket);
+        if (i != bucket_slots) {
+            slots[bucket * bucket_slots + i] = key;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Key>
+void BasicLocalCuckooHash<Key>::grow(Key pending) {
+    std::vector<Key> keys;
+    keys.reserve(size_ + 1);
+    for (const slot_type& slot : slots) {
+        if (slot) keys.push_back(*slot);
+    }
+    keys.push_back(pending);
+
+    // a failed chain during the rebuild moves on to the next rung
+    bool placed = false;
+    while (!placed) {
+        ++size_index;
+        ++times_rehashed_;
+        seed = generator();
+        slots.assign(slots_for<Key>(size_index), std::nullopt);
+
+        placed = true;
+        for (Key key : keys) {
+            if (!place(key)) {
+                placed = false;
+                break;
+            }
+        }
+    }
+    size_ = keys.size();
+}
+
+template class BasicLocalCuckooHash<int>;
+template class BasicLocalCuckooHash<int64_t>;
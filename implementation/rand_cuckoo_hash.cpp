@@ -2,36 +2,71 @@
 #include <iostream>
 
 // create hash using Carter and Wegmans' ((ax+b) mod p) mod m
-size_t RandCuckooHash::hash_1(int key) {
-    return (realModulo((int64_t)a1 * key + b1, modulus_p)) % capacity_;
+template <typename Key>
+size_t BasicRandCuckooHash<Key>::universalHash(Key key, uint64_t a, uint64_t b, uint64_t c) const {
+    if constexpr (wide_keys) {
+        // split the key so each part is below p, which keeps the family universal over all 64-bit keys
+        return carter_wegman_61(a, b, c, static_cast<uint64_t>(key)) % this->capacity_;
+    } else {
+        return (realModulo((int64_t)a * key + b, modulus_p)) % this->capacity_;
+    }
 }
 
-size_t RandCuckooHash::hash_2(int key) {
-    return (realModulo((int64_t)a2 * key + b2, modulus_p)) % capacity_;
+template <typename Key>
+size_t BasicRandCuckooHash<Key>::hash_1(Key key) {
+    return universalHash(key, a1, b1, c1);
 }
 
-void RandCuckooHash::printHash1() {
-    if (!suppress_logs) std::cout << "h1 = ((" << a1 << "k + " << b1 << ") mod " << modulus_p << ") mod " << capacity_ << std::endl;
+template <typename Key>
+size_t BasicRandCuckooHash<Key>::hash_2(Key key) {
+    return universalHash(key, a2, b2, c2);
 }
-void RandCuckooHash::printHash2() {
-    if (!suppress_logs) std::cout << "h2 = ((" << a2 << "k + " << b2 << ") mod " << modulus_p << ") mod " << capacity_ << std::endl;
+
+template <typename Key>
+void BasicRandCuckooHash<Key>::printHash1() {
+    if (suppress_logs) return;
+    if constexpr (wide_keys) std::cout << "h1 = ((" << a1 << "k_hi + " << c1 << "k_lo + " << b1 << ") mod " << modulus_p << ") mod " << this->capacity_ << std::endl;
+    else std::cout << "h1 = ((" << a1 << "k + " << b1 << ") mod " << modulus_p << ") mod " << this->capacity_ << std::endl;
+}
+
+template <typename Key>
+void BasicRandCuckooHash<Key>::printHash2() {
+    if (suppress_logs) return;
+    if constexpr (wide_keys) std::cout << "h2 = ((" << a2 << "k_hi + " << c2 << "k_lo + " << b2 << ") mod " << modulus_p << ") mod " << this->capacity_ << std::endl;
+    else std::cout << "h2 = ((" << a2 << "k + " << b2 << ") mod " << modulus_p << ") mod " << this->capacity_ << std::endl;
 }
 
-void RandCuckooHash::genNewHashes() {
-    std::uniform_int_distribution<uint32_t> rangeA(1, modulus_p - 1);
-    std::uniform_int_distribution<uint32_t> rangeB(0, modulus_p - 1);
+template <typename Key>
+void BasicRandCuckooHash<Key>::genNewHashes() {
+    std::uniform_int_distribution<uint64_t> rangeA(1, modulus_p - 1);
+    std::uniform_int_distribution<uint64_t> rangeB(0, modulus_p - 1);
 
     a1 = rangeA(generator);
     b1 = rangeB(generator);
     a2 = rangeA(generator);
     b2 = rangeB(generator);
+
+    // c only multiplies the low half of 64-bit keys
+    if constexpr (wide_keys) {
+        c1 = rangeA(generator);
+        c2 = rangeA(generator);
+    }
 }
 
-void RandCuckooHash::rehash(size_t new_size) {
+template <typename Key>
+bool BasicRandCuckooHash<Key>::reseed() {
     genNewHashes();
+    return true;
+}
 
-    CuckooHash::rehash(new_size);
+template <typename Key>
+void BasicRandCuckooHash<Key>::rehash(size_t new_size) {
+    // fresh hashes come from reseed(), which the base rebuild calls when a chain fails
+    BasicCuckooHash<Key>::rehash(new_size);
 
     this->printHash1();
     this->printHash2();
-}
\ No newline at end of file
+}
+
+template class BasicRandCuckooHash<int>;
+template class BasicRandCuckooHash<int64_t>;
@@ -0,0 +1,356 @@
+// POSIX shared memory only; the build leaves this file out elsewhere, and the guard keeps it inert if listed anyway
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "shared_cuckoo_hash.hpp"
+#include "cuckoo_hash.hpp"
+#include "hash_mix.hpp"
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    [[noreturn]] void throwErrno(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+}
+
+template <typename Key>
+BasicSharedCuckooHash<Key> BasicSharedCuckooHash<Key>::create(const std::string& name, size_t expected_keys) {
+    // start from a fresh segment, a stale one could have a different layout
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) throwErrno("shm_open " + name);
+
+    BasicSharedCuckooHash table(fd, true, name);
+    size_t size_index = 0;
+    while (BasicCuckooHash<Key>::capacity_for(size_index) * 2 * max_load < expected_keys) ++size_index;
+    size_t capacity = BasicCuckooHash<Key>::capacity_for(size_index);
+
+    size_t bytes = segmentBytes(capacity);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == -1) throwErrno("ftruncate " + name);
+    table.map(bytes);
+
+    Header* h = new (table.base) Header{};
+    h->key_size = sizeof(Key);
+    h->capacity.store(capacity);
+    h->size_index.store(size_index);
+    table.genNewHashes();
+    for (size_t i = 0; i < 2 * capacity; ++i) new (table.h1() + i) Slot{};
+    // readers check the magic last, once everything else is in place
+    h->magic.store(magic_value, std::memory_order_release);
+    return table;
+}
+
+template <typename Key>
+BasicSharedCuckooHash<Key> BasicSharedCuckooHash<Key>::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) throwErrno("shm_open " + name);
+
+    BasicSharedCuckooHash table(fd, false, name);
+    struct stat st{};
+    if (fstat(fd, &st) == -1) throwErrno("fstat " + name);
+    if (static_cast<size_t>(st.st_size) < slotsOffset()) throw std::runtime_error(name + " is not a shared cuckoo table");
+    table.map(static_cast<size_t>(st.st_size));
+
+    // acquire pairs with create()'s release, so a reader that sees the magic sees the initialised header
+    if (table.header()->magic.load(std::memory_order_acquire) != magic_value || table.header()->key_size != sizeof(Key)) {
+        throw std::runtime_error(name + " is not a shared cuckoo table with this key type");
+    }
+    // the writer resizes the segment before publishing a larger capacity, so a shorter one is damaged
+    if (static_cast<size_t>(st.st_size) < segmentBytes(table.header()->capacity.load(std::memory_order_relaxed))) {
+        throw std::runtime_error(name + " is shorter than its capacity needs");
+    }
+    return table;
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::unlink(const std::string& name) {
+    if (shm_unlink(name.c_str()) == -1 && errno != ENOENT) throwErrno("shm_unlink " + name);
+}
+
+template <typename Key>
+BasicSharedCuckooHash<Key>::BasicSharedCuckooHash(int fd, bool writable, std::string name)
+    : fd(fd), writable(writable), name(std::move(name)), generator(std::random_device{}()) {}
+
+template <typename Key>
+BasicSharedCuckooHash<Key>::BasicSharedCuckooHash(BasicSharedCuckooHash&& other) noexcept
+    : fd(std::exchange(other.fd, -1)),
+      writable(other.writable),
+      name(std::move(other.name)),
+      base(std::exchange(other.base, nullptr)),
+      mapped_bytes(std::exchange(other.mapped_bytes, 0)),
+      generator(other.generator) {}
+
+template <typename Key>
+BasicSharedCuckooHash<Key>::~BasicSharedCuckooHash() {
+    if (base) munmap(base, mapped_bytes);
+    if (fd != -1) close(fd);
+}
+
+template <typename Key>
+size_t BasicSharedCuckooHash<Key>::slotsOffset() {
+    // keep the slot arrays off the header's cache line
+    return (sizeof(Header) + 63) & ~size_t{63};
+}
+
+template <typename Key>
+size_t BasicSharedCuckooHash<Key>::segmentBytes(size_t capacity) {
+    return slotsOffset() + 2 * capacity * sizeof(Slot);
+}
+
+template <typename Key>
+typename BasicSharedCuckooHash<Key>::Slot* BasicSharedCuckooHash<Key>::h1() const {
+    return reinterpret_cast<Slot*>(static_cast<char*>(base) + slotsOffset());
+}
+
+template <typename Key>
+typename BasicSharedCuckooHash<Key>::Slot* BasicSharedCuckooHash<Key>::h2() const {
+    return h1() + header()->capacity.load(std::memory_order_relaxed);
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::map(size_t bytes) {
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* mapped = mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) throwErrno("mmap " + name);
+    if (base) munmap(base, mapped_bytes);
+    base = mapped;
+    mapped_bytes = bytes;
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::requireWriter() const {
+    if (!writable) throw std::logic_error(name + " is opened read-only");
+}
+
+// h(k) = ((a * k_hi + c * k_lo + b) mod p) mod capacity, both halves are below p so the family stays universal
+template <typename Key>
+size_t BasicSharedCuckooHash<Key>::hash(Key key, uint64_t a, uint64_t b, uint64_t c, size_t capacity) const {
+    return carter_wegman_61(a, b, c, static_cast<uint64_t>(key)) % capacity;
+}
+
+template <typename Key>
+template <typename Fn>
+auto BasicSharedCuckooHash<Key>::consistentRead(Fn&& fn) {
+    for (int attempt = 0;; ++attempt) {
+        // the writer may hold the sequence odd for a whole rebuild, stop burning its CPU after a few spins
+        if (attempt >= 16) std::this_thread::yield();
+
+        uint64_t before = header()->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        size_t capacity = header()->capacity.load(std::memory_order_relaxed);
+        if (segmentBytes(capacity) > mapped_bytes) {
+            // the writer grew the segment since we mapped it
+            struct stat st{};
+            if (fstat(fd, &st) == -1) throwErrno("fstat " + name);
+            // ftruncate precedes the capacity store, so waiting for the segment to grow would never end
+            if (static_cast<size_t>(st.st_size) < segmentBytes(capacity)) {
+                throw std::runtime_error(name + " is shorter than its capacity needs");
+            }
+            map(static_cast<size_t>(st.st_size));
+            continue;
+        }
+
+        auto result = fn(capacity);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header()->sequence.load(std::memory_order_relaxed) == before) return result;
+    }
+}
+
+template <typename Key>
+int BasicSharedCuckooHash<Key>::contains(Key key) {
+    return consistentRead([&](size_t capacity) {
+        const Header* h = header();
+        const Slot& first = h1()[hash(key, h->a1.load(std::memory_order_relaxed), h->b1.load(std::memory_order_relaxed),
+                                      h->c1.load(std::memory_order_relaxed), capacity)];
+        if (first.used.load(std::memory_order_relaxed) && first.key.load(std::memory_order_relaxed) == key) return 1;
+
+        const Slot& second = h1()[capacity + hash(key, h->a2.load(std::memory_order_relaxed), h->b2.load(std::memory_order_relaxed),
+                                                  h->c2.load(std::memory_order_relaxed), capacity)];
+        if (second.used.load(std::memory_order_relaxed) && second.key.load(std::memory_order_relaxed) == key) return 2;
+        return -1;
+    });
+}
+
+template <typename Key>
+std::optional<Key> BasicSharedCuckooHash<Key>::find(Key key) {
+    if (contains(key) == -1) return std::nullopt;
+    return key;
+}
+
+template <typename Key>
+size_t BasicSharedCuckooHash<Key>::size() {
+    return header()->size.load(std::memory_order_acquire);
+}
+
+template <typename Key>
+size_t BasicSharedCuckooHash<Key>::capacity() {
+    return 2 * header()->capacity.load(std::memory_order_acquire);
+}
+
+template <typename Key>
+bool BasicSharedCuckooHash<Key>::empty() {
+    return size() == 0;
+}
+
+template <typename Key>
+int BasicSharedCuckooHash<Key>::times_rehashed() const {
+    return static_cast<int>(header()->times_rehashed.load());
+}
+
+template <typename Key>
+uint64_t BasicSharedCuckooHash<Key>::sequence() const {
+    return header()->sequence.load();
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::beginWrite() {
+    header()->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::endWrite() {
+    header()->sequence.fetch_add(1, std::memory_order_release);
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::genNewHashes() {
+    std::uniform_int_distribution<uint64_t> rangeA(1, mersenne_61 - 1);
+    std::uniform_int_distribution<uint64_t> rangeB(0, mersenne_61 - 1);
+
+    Header* h = header();
+    h->a1.store(rangeA(generator), std::memory_order_relaxed);
+    h->b1.store(rangeB(generator), std::memory_order_relaxed);
+    h->c1.store(rangeA(generator), std::memory_order_relaxed);
+    h->a2.store(rangeA(generator), std::memory_order_relaxed);
+    h->b2.store(rangeB(generator), std::memory_order_relaxed);
+    h->c2.store(rangeA(generator), std::memory_order_relaxed);
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::insert(Key key) {
+    requireWriter();
+    if (contains(key) != -1) return;
+
+    beginWrite();
+    Header* h = header();
+    size_t capacity = h->capacity.load(std::memory_order_relaxed);
+    bool grow = h->size.load(std::memory_order_relaxed) + 1 > max_load * 2 * capacity;
+
+    Key homeless = key;
+    if (grow || !place(homeless)) {
+        std::vector<Key> keys = collectKeys();
+        keys.push_back(homeless);
+        if (grow) {
+            h->size_index.fetch_add(1, std::memory_order_relaxed);
+            capacity = BasicCuckooHash<Key>::capacity_for(h->size_index.load(std::memory_order_relaxed));
+        }
+        rebuild(keys, capacity);
+    } else {
+        h->size.fetch_add(1, std::memory_order_relaxed);
+    }
+    endWrite();
+}
+
+template <typename Key>
+bool BasicSharedCuckooHash<Key>::erase(Key key) {
+    requireWriter();
+    int position = contains(key);
+    if (position == -1) return false;
+
+    beginWrite();
+    Header* h = header();
+    size_t capacity = h->capacity.load(std::memory_order_relaxed);
+    Slot& slot = position == 1
+        ? h1()[hash(key, h->a1.load(std::memory_order_relaxed), h->b1.load(std::memory_order_relaxed), h->c1.load(std::memory_order_relaxed), capacity)]
+        : h2()[hash(key, h->a2.load(std::memory_order_relaxed), h->b2.load(std::memory_order_relaxed), h->c2.load(std::memory_order_relaxed), capacity)];
+    slot.used.store(0, std::memory_order_relaxed);
+    h->size.fetch_sub(1, std::memory_order_relaxed);
+    endWrite();
+    return true;
+}
+
+template <typename Key>
+bool BasicSharedCuckooHash<Key>::place(Key& key) {
+    Header* h = header();
+    size_t capacity = h->capacity.load(std::memory_order_relaxed);
+
+    for (size_t step = 0; step < max_kicks; ++step) {
+        bool first = step % 2 == 0;
+        Slot& slot = first
+            ? h1()[hash(key, h->a1.load(std::memory_order_relaxed), h->b1.load(std::memory_order_relaxed), h->c1.load(std::memory_order_relaxed), capacity)]
+            : h2()[hash(key, h->a2.load(std::memory_order_relaxed), h->b2.load(std::memory_order_relaxed), h->c2.load(std::memory_order_relaxed), capacity)];
+
+        if (!slot.used.load(std::memory_order_relaxed)) {
+            slot.key.store(key, std::memory_order_relaxed);
+            slot.used.store(1, std::memory_order_relaxed);
+            return true;
+        }
+        Key evicted = slot.key.load(std::memory_order_relaxed);
+        slot.key.store(key, std::memory_order_relaxed);
+        key = evicted;
+    }
+    return false;
+}
+
+template <typename Key>
+std::vector<Key> BasicSharedCuckooHash<Key>::collectKeys() const {
+    std::vector<Key> keys;
+    size_t slots = 2 * header()->capacity.load(std::memory_order_relaxed);
+    keys.reserve(header()->size.load(std::memory_order_relaxed) + 1);
+    for (size_t i = 0; i < slots; ++i) {
+        if (h1()[i].used.load(std::memory_order_relaxed)) keys.push_back(h1()[i].key.load(std::memory_order_relaxed));
+    }
+    return keys;
+}
+
+template <typename Key>
+void BasicSharedCuckooHash<Key>::rebuild(const std::vector<Key>& keys, size_t new_capacity) {
+    Header* h = header();
+    while (true) {
+        for (int attempt = 0; attempt < max_reseeds; ++attempt) {
+            h->times_rehashed.fetch_add(1, std::memory_order_relaxed);
+
+            size_t bytes = segmentBytes(new_capacity);
+            if (bytes > mapped_bytes) {
+                if (ftruncate(fd, static_cast<off_t>(bytes)) == -1) throwErrno("ftruncate " + name);
+                map(bytes);
+                h = header();
+            }
+            h->capacity.store(new_capacity, std::memory_order_relaxed);
+            genNewHashes();
+            for (size_t i = 0; i < 2 * new_capacity; ++i) new (h1() + i) Slot{};
+
+            bool placed = true;
+            for (Key key : keys) {
+                if (!place(key)) {
+                    placed = false;
+                    break;
+                }
+            }
+            if (placed) {
+                h->size.store(keys.size(), std::memory_order_relaxed);
+                return;
+            }
+        }
+        // every reseed failed at this capacity, move up the ladder with a fresh budget
+        h->size_index.fetch_add(1, std::memory_order_relaxed);
+        new_capacity = BasicCuckooHash<Key>::capacity_for(h->size_index.load(std::memory_order_relaxed));
+    }
+}
+
+template class BasicSharedCuckooHash<int>;
+template class BasicSharedCuckooHash<int64_t>;
+
+#endif
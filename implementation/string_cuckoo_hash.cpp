@@ -0,0 +1,197 @@
+#include "string_cuckoo_hash.hpp"
+#include "cuckoo_hash.hpp"
+#include "hash_mix.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    constexpr size_t window_slots = StringCuckooHash::window_buckets * StringCuckooHash::bucket_slots;
+
+    // whole windows only, so the XOR of any bucket with a tag stays inside the array
+    size_t slots_for(size_t size_index) {
+        size_t wanted = 2 * BasicCuckooHash<int>::capacity_for(size_index);
+        return (wanted + window_slots - 1) / window_slots * window_slots;
+    }
+
+    // index of the first empty entry in the bucket starting at base, bucket_slots if it is full
+    size_t empty_in(const StringCuckooHash::Entry* base) {
+        for (size_t i = 0; i < StringCuckooHash::bucket_slots; ++i) {
+            if (base[i].fingerprint == 0) return i;
+        }
+        return StringCuckooHash::bucket_slots;
+    }
+}
+
+StringCuckooHash::StringCuckooHash(int size_index, uint64_t seed, float max_load)
+    : entries(slots_for(size_index)), size_index(size_index), max_load(max_load), generator(seed) {
+    this->seed = generator();
+}
+
+uint64_t StringCuckooHash::hash(std::string_view key) const {
+    // eight bytes at a time through the murmur finaliser, the length folded into the start
+    const char* p = key.data();
+    size_t n = key.size();
+    uint64_t h = seed ^ (n * 0x9e3779b97f4a7c15ull);
+    // an empty view may have a null data(), which memcpy must not be handed
+    if (n == 0) return mix64(h);
+    while (n >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = mix64(h ^ word) + 0x9e3779b97f4a7c15ull;
+        p += 8;
+        n -= 8;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, n);
+    return mix64(h ^ tail);
+}
+
+size_t StringCuckooHash::first_bucket(uint64_t h) const {
+    return static_cast<size_t>(reduce_range(h, entries.size() / bucket_slots));
+}
+
+const StringCuckooHash::Entry* StringCuckooHash::locate(std::string_view key, uint64_t h) const {
+    uint32_t fp = fingerprint(h);
+    size_t bucket = first_bucket(h);
+    size_t other = alternate(bucket, fp);
+    // both buckets share a page, so the second line can be in flight while the first is compared
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&entries[other * bucket_slots]);
+#endif
+    for (size_t candidate : {bucket, other}) {
+        const Entry* base = &entries[candidate * bucket_slots];
+        for (size_t i = 0; i < bucket_slots; ++i) {
+            // key bytes are only read once fingerprint and length agree
+            if (base[i].fingerprint == fp && base[i].length == key.size() && key_of(base[i]) == key) return &base[i];
+        }
+    }
+    return nullptr;
+}
+
+void StringCuckooHash::insert(std::string_view key) {
+    uint64_t h = hash(key);
+    if (locate(key, h)) return;
+    if (key.size() > UINT32_MAX) throw std::length_error("Key longer than 4 GiB");
+
+    // key may be a view of erased bytes still in the arena, which the resize can move
+    size_t offset = arena.size();
+    bool aliased = !arena.empty() && key.data() >= arena.data() && key.data() < arena.data() + arena.size();
+    size_t source = aliased ? static_cast<size_t>(key.data() - arena.data()) : 0;
+    arena.resize(offset + key.size());
+    if (!key.empty()) std::memcpy(arena.data() + offset, aliased ? arena.data() + source : key.data(), key.size());
+
+    Entry entry{fingerprint(h), static_cast<uint32_t>(key.size()), offset};
+    if (static_cast<float>(size_ + 1) > max_load * static_cast<float>(entries.size())) {
+        grow(entry);
+        return;
+    }
+    if (place(entry, first_bucket(h))) ++size_;
+    // the chain ran out, entry now holds whichever entry was left without a slot
+    else grow(entry);
+}
+
+int StringCuckooHash::contains(std::string_view key) const {
+    uint64_t h = hash(key);
+    const Entry* entry = locate(key, h);
+    if (!entry) return -1;
+    size_t bucket = static_cast<size_t>(entry - entries.data()) / bucket_slots;
+    return bucket == first_bucket(h) ? 1 : 2;
+}
+
+std::optional<std::string_view> StringCuckooHash::find(std::string_view key) const {
+    const Entry* entry = locate(key, hash(key));
+    if (!entry) return std::nullopt;
+    return key_of(*entry);
+}
+
+bool StringCuckooHash::erase(std::string_view key) {
+    const Entry* found = locate(key, hash(key));
+    if (!found) return false;
+
+    Entry& entry = entries[static_cast<size_t>(found - entries.data())];
+    dead_bytes += entry.length;
+    entry = Entry{};
+    --size_;
+    // once most of the arena is garbage, pack it so deletes cannot grow it without bound
+    if (dead_bytes > page_bytes && dead_bytes > arena.size() / 2) compact();
+    return true;
+}
+
+bool StringCuckooHash::place(Entry& entry, size_t bucket) {
+    size_t other = alternate(bucket, entry.fingerprint);
+    for (size_t candidate : {bucket, other}) {
+        Entry* base = &entries[candidate * bucket_slots];
+        size_t i = empty_in(base);
+        if (i != bucket_slots) {
+            base[i] = entry;
+            return true;
+        }
+    }
+
+    // both full: random walk, each kicked entry moves to its other bucket, found from its fingerprint
+    if (generator() & 1) bucket = other;
+    for (int kick = 0; kick < max_kicks; ++kick) {
+        std::swap(entry, entries[bucket * bucket_slots + generator() % bucket_slots]);
+        bucket = alternate(bucket, entry.fingerprint);
+        Entry* base = &entries[bucket * bucket_slots];
+        size_t i = empty_in(base);
+        if (i != bucket_slots) {
+            base[i] = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StringCuckooHash::grow(Entry pending) {
+    // pack the live keys into a fresh arena, the fingerprints are recomputed under the new seed
+    std::vector<Entry> live;
+    live.reserve(size_ + 1);
+    std::vector<char> packed;
+    packed.reserve(arena.size() - dead_bytes);
+    auto keep = [&](const Entry& entry) {
+        live.push_back(Entry{0, entry.length, packed.size()});
+        std::string_view key = key_of(entry);
+        packed.insert(packed.end(), key.begin(), key.end());
+    };
+    for (const Entry& entry : entries) {
+        if (entry.fingerprint != 0) keep(entry);
+    }
+    keep(pending);
+    arena.swap(packed);
+    dead_bytes = 0;
+
+    // a failed chain during the rebuild moves on to the next rung
+    bool placed = false;
+    while (!placed) {
+        ++size_index;
+        ++times_rehashed_;
+        seed = generator();
+        entries.assign(slots_for(size_index), Entry{});
+
+        placed = true;
+        for (const Entry& entry : live) {
+            uint64_t h = hash(key_of(entry));
+            Entry moving{fingerprint(h), entry.length, entry.offset};
+            if (!place(moving, first_bucket(h))) {
+                placed = false;
+                break;
+            }
+        }
+    }
+    size_ = live.size();
+}
+
+void StringCuckooHash::compact() {
+    std::vector<char> packed;
+    packed.reserve(arena.size() - dead_bytes);
+    for (Entry& entry : entries) {
+        if (entry.fingerprint == 0) continue;
+        std::string_view key = key_of(entry);
+        entry.offset = packed.size();
+        packed.insert(packed.end(), key.begin(), key.end());
+    }
+    arena.swap(packed);
+    dead_bytes = 0;
+}
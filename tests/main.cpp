@@ -1,12 +1,35 @@
 #include "cuckoo_hash.hpp"
 #include "rand_cuckoo_hash.hpp"
+#include "keyed_cuckoo_hash.hpp"
+#include "huge_page_resource.hpp"
+#include "read_mostly_cuckoo_hash.hpp"
+#include "static_cuckoo_set.hpp"
+#include "hash_join.hpp"
+#include "group_by.hpp"
+#include "cuckoo_set_ops.hpp"
+#include "cuckoo_cache.hpp"
+#include "local_cuckoo_hash.hpp"
+#include "string_cuckoo_hash.hpp"
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <limits.h>
 #include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
+// shared-memory tables need POSIX shm and fork
+#if defined(__unix__) || defined(__APPLE__)
+#include "shared_cuckoo_hash.hpp"
+#include <sys/wait.h>
+#include <unistd.h>
+#define CUCKOO_HAVE_SHM 1
+#endif
+
 namespace{
     std::unordered_set<int> random_set(int total_numbers, int low_rage, int high_range){
         std::random_device rand;
@@ -653,6 +676,908 @@ TEST(compare_deterministic_and_universal, adversarial_keys) {
     EXPECT_EQ(rand_table.times_rehashed(), 1);
 }
 
+// <-----------------------------------------------------------------64-BIT KEY TESTS-------------------------------------------------------------->
+
+TEST(wide_key_tests, insert_keys_beyond_int_range) {
+    std::vector<int64_t> values{0, -1, 4'294'967'296, -4'294'967'296, 9'223'372'036'854'775'807LL,
+                                -9'223'372'036'854'775'807LL - 1, 1'000'000'000'000'007, 42};
+    CuckooHash64 table;
+    RandCuckooHash64 rand_table(0, 1388210758, true);
+
+    for (int64_t v : values) {
+        table.insert(v);
+        rand_table.insert(v);
+    }
+
+    ASSERT_EQ(table.size(), values.size());
+    ASSERT_EQ(rand_table.size(), values.size());
+    for (int64_t v : values) {
+        ASSERT_EQ(*table.find(v), v);
+        ASSERT_EQ(*rand_table.find(v), v);
+    }
+
+    // keys that only differ above bit 32 must not alias
+    ASSERT_EQ(rand_table.contains(4'294'967'297), -1);
+    ASSERT_TRUE(rand_table.erase(4'294'967'296));
+    ASSERT_EQ(rand_table.contains(4'294'967'296), -1);
+    ASSERT_EQ(*rand_table.find(-4'294'967'296), -4'294'967'296);
+}
+
+TEST(wide_key_tests, random_64bit_keys_stress) {
+    std::mt19937_64 gen(1388230758);// NOLINT(cert-msc51-cpp)
+    RandCuckooHash64 table(0, 1388210758, true);
+    std::unordered_set<int64_t> standard;
+
+    for (int i = 0; i < 100'000; ++i) {
+        int64_t key = static_cast<int64_t>(gen());
+        table.insert(key);
+        standard.insert(key);
+    }
+
+    ASSERT_EQ(table.size(), standard.size());
+    for (int64_t x : standard) {
+        ASSERT_EQ(*table.find(x), x);
+    }
+}
+
+TEST(wide_key_tests, test_family_universality_64bit) {
+    // pairs that collide if keys were simply truncated or folded mod 2^61 - 1
+    int64_t x1 = 7, y1 = 7 + (int64_t{1} << 32);
+    int64_t x2 = 5, y2 = 5 + ((int64_t{1} << 61) - 1);
+    int64_t x3 = -1, y3 = 0x7fffffffffffffffLL;
+
+    int pair1_collisions = 0;
+    int pair2_collisions = 0;
+    int pair3_collisions = 0;
+
+    int num_of_runs = 1000000;
+
+    // make table capacity 1109, use arbitrary seed
+    RandCuckooHash64 table(6, 1388210758, true);
+    for (int i = 0; i < num_of_runs; i++) {
+        if (table.hash_1(x1) == table.hash_1(y1)) pair1_collisions++;
+        if (table.hash_1(x2) == table.hash_1(y2)) pair2_collisions++;
+        if (table.hash_1(x3) == table.hash_1(y3)) pair3_collisions++;
+
+        table.genNewHashes();
+    }
+
+    float expected = 1 / ((float) table.capacity() / 2);
+    const double standard_error = std::sqrt(expected * (1 - expected) / (float) num_of_runs);
+    const double acceptable_range = standard_error * 3;
+
+    EXPECT_NEAR(expected, (float) pair1_collisions / (float) num_of_runs, acceptable_range);
+    EXPECT_NEAR(expected, (float) pair2_collisions / (float) num_of_runs, acceptable_range);
+    EXPECT_NEAR(expected, (float) pair3_collisions / (float) num_of_runs, acceptable_range);
+}
+
+TEST(wide_key_tests, capacity_grows_past_sizes_ladder) {
+    // first rungs are unchanged
+    ASSERT_EQ(CuckooHash::capacity_for(0), 13);
+    ASSERT_EQ(CuckooHash::capacity_for(18), 10'000'019);
+
+    size_t previous = CuckooHash::capacity_for(18);
+    for (size_t i = 19; i < 30; ++i) {
+        size_t capacity = CuckooHash64::capacity_for(i);
+        ASSERT_GT(capacity, 2 * previous);
+        ASSERT_LT(capacity, 2 * previous + 1'000);
+        // odd and not divisible by small primes
+        for (size_t p : {2, 3, 5, 7, 11, 13}) {
+            ASSERT_NE(capacity % p, 0);
+        }
+        previous = capacity;
+    }
+
+    // well past 4 billion slots per array
+    ASSERT_GT(CuckooHash64::capacity_for(29), 10'000'000'000ull);
+}
+
+// <-----------------------------------------------------------------ALLOCATOR TESTS-------------------------------------------------------------->
+
+TEST(allocator_tests, huge_page_resource_backs_slot_arrays) {
+    HugePageResource huge_pages;
+    {
+        // 351061 slots per array is well above the mmap threshold
+        RandCuckooHash table(14, 1388210758, true, &huge_pages);
+        ASSERT_EQ(table.resource(), &huge_pages);
+        ASSERT_GE(huge_pages.mapped_bytes(), 2 * HugePageResource::huge_page_size);
+
+        std::unordered_set<int> values = random_set(400'000, INT_MIN, INT_MAX);
+        for (int x : values) table.insert(x);
+
+        // rehashes keep allocating from the same resource
+        ASSERT_GE(table.times_rehashed(), 1);
+        ASSERT_EQ(table.resource(), &huge_pages);
+        ASSERT_EQ(huge_pages.mapped_bytes() % HugePageResource::huge_page_size, 0);
+        ASSERT_EQ(table.size(), values.size());
+        for (int x : values) {
+            ASSERT_EQ(*table.find(x), x);
+        }
+    }
+    ASSERT_EQ(huge_pages.mapped_bytes(), 0);
+}
+
+TEST(allocator_tests, user_arena) {
+    // fixed arena with no upstream, so any allocation outside it would throw
+    std::array<std::byte, 64 * 1024> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    CuckooHash table(0, &arena);
+    for (int i = 0; i < 200; ++i) {
+        table.insert(i);
+    }
+
+    ASSERT_EQ(table.size(), 200);
+    ASSERT_EQ(table.resource(), &arena);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(table.contains(i) == 1 || table.contains(i) == 2);
+    }
+}
+
+// <-----------------------------------------------------------------READ-MOSTLY TESTS-------------------------------------------------------------->
+
+TEST(read_mostly_tests, update_publishes_new_snapshot) {
+    ReadMostlyCuckooHash<CuckooHash> set(std::make_unique<CuckooHash>(std::initializer_list<int>{1, 2, 3}));
+    auto reader = set.reader();
+
+    ASSERT_EQ(reader.size(), 3);
+    ASSERT_EQ(reader.contains(4), -1);
+
+    set.update([](CuckooHash& table) { table.insert(4); });
+    ASSERT_NE(reader.contains(4), -1);
+    ASSERT_EQ(*reader.find(4), 4);
+
+    // a full rebuild replaces everything
+    set.publish(std::make_unique<CuckooHash>(std::initializer_list<int>{10}));
+    ASSERT_EQ(reader.size(), 1);
+    ASSERT_EQ(reader.contains(1), -1);
+    ASSERT_EQ(set.epoch(), 2);
+
+    // nobody is reading, so both replaced snapshots are already gone
+    ASSERT_EQ(set.retired_count(), 0);
+}
+
+TEST(read_mostly_tests, snapshot_outlives_publish_while_read) {
+    ReadMostlyCuckooHash<CuckooHash> set(std::make_unique<CuckooHash>(std::initializer_list<int>{1}));
+    auto reader = set.reader();
+
+    reader.read([&](CuckooHash& snapshot) {
+        // publishing while inside a read must not free the snapshot being read
+        set.update([](CuckooHash& table) { table.erase(1); });
+        EXPECT_EQ(set.retired_count(), 1);
+        EXPECT_EQ(snapshot.contains(1), 1);
+        return 0;
+    });
+
+    ASSERT_EQ(reader.contains(1), -1);
+    ASSERT_EQ(set.reclaim(), 0);
+}
+
+TEST(read_mostly_tests, concurrent_readers_during_republish) {
+    ReadMostlyCuckooHash<RandCuckooHash> set(std::make_unique<RandCuckooHash>(0, 1388210758, true));
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            auto reader = set.reader();
+            while (!done.load()) {
+                // every snapshot holds exactly the keys 0..size-1
+                reader.read([&](RandCuckooHash& snapshot) {
+                    int n = static_cast<int>(snapshot.size());
+                    if (n > 0 && snapshot.contains(n - 1) == -1) ++inconsistent;
+                    if (snapshot.contains(n) != -1) ++inconsistent;
+                    return 0;
+                });
+            }
+        });
+    }
+
+    for (int i = 0; i < 500; ++i) {
+        set.update([i](RandCuckooHash& table) { table.insert(i); });
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+
+    ASSERT_EQ(inconsistent.load(), 0);
+    ASSERT_EQ(set.reader().size(), 500);
+    ASSERT_EQ(set.reclaim(), 0);
+}
+
+// <-----------------------------------------------------------------FROZEN TABLE TESTS-------------------------------------------------------------->
+
+TEST(frozen_tests, freeze_keeps_every_key) {
+    RandCuckooHash table(0, 1388210758, true);
+    std::unordered_set<int> values = random_set(100'000, INT_MIN, INT_MAX);
+    for (int x : values) table.insert(x);
+
+    FrozenCuckooHash frozen = table.freeze();
+
+    ASSERT_EQ(frozen.size(), values.size());
+    for (int x : values) {
+        ASSERT_NE(frozen.contains(x), -1);
+        ASSERT_EQ(*frozen.find(x), x);
+    }
+
+    // probes that were never inserted must miss, including against the filler in empty slots
+    std::mt19937 gen(1388230758);// NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+    for (int i = 0; i < 100'000; ++i) {
+        int probe = dist(gen);
+        ASSERT_EQ(frozen.contains(probe) != -1, values.contains(probe));
+    }
+}
+
+TEST(frozen_tests, capacity_is_tight) {
+    CuckooHash table;
+    for (int i = 0; i < 50'000; ++i) table.insert(i);
+
+    FrozenCuckooHash frozen = table.freeze();
+
+    // mutable table runs at or below 50% load, the frozen one close to the 95% target
+    ASSERT_LE(table.load_factor(), 0.5f);
+    ASSERT_GE(frozen.load_factor(), 0.85f);
+    ASSERT_LT(frozen.memory_bytes(), table.capacity() * sizeof(std::optional<int>) / 3);
+}
+
+TEST(frozen_tests, freeze_empty_and_64bit) {
+    CuckooHash empty_table;
+    FrozenCuckooHash empty_frozen = empty_table.freeze();
+    ASSERT_TRUE(empty_frozen.empty());
+    ASSERT_EQ(empty_frozen.contains(0), -1);
+
+    CuckooHash64 table{-1, 0, 1, int64_t{1} << 40, -(int64_t{1} << 40)};
+    FrozenCuckooHash64 frozen = table.freeze();
+    ASSERT_EQ(frozen.size(), 5);
+    ASSERT_NE(frozen.contains(int64_t{1} << 40), -1);
+    ASSERT_EQ(frozen.contains((int64_t{1} << 40) + 1), -1);
+    ASSERT_EQ(frozen.contains(2), -1);
+}
+
+TEST(frozen_tests, duplicate_keys_stored_once) {
+    // more copies of one key than its two buckets hold would never place
+    std::vector<int> keys(20, 41);
+    for (int i = 0; i < 1'000; ++i) keys.push_back(i * 7);
+
+    FrozenCuckooHash frozen(keys);
+    ASSERT_EQ(frozen.size(), 1'000 + 1);
+    ASSERT_NE(frozen.contains(41), -1);
+    for (int i = 0; i < 1'000; ++i) ASSERT_NE(frozen.contains(i * 7), -1);
+    ASSERT_EQ(frozen.contains(43), -1);
+}
+
+TEST(frozen_tests, save_and_load) {
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 20'000; ++i) keys.push_back(i * 104'729 - (int64_t{1} << 35));
+    FrozenCuckooHash64 frozen(keys);
+
+    std::stringstream image;
+    frozen.save(image);
+    FrozenCuckooHash64 loaded = FrozenCuckooHash64::load(image);
+
+    ASSERT_EQ(loaded.size(), frozen.size());
+    ASSERT_EQ(loaded.slot_array(), frozen.slot_array());
+    for (int64_t key : keys) ASSERT_EQ(loaded.slot_of(key), frozen.slot_of(key));
+    ASSERT_EQ(loaded.contains(1), -1);
+
+    // an image of 64-bit keys is not readable as a 32-bit table, nor is a truncated one
+    image.clear();
+    image.seekg(0);
+    ASSERT_THROW(FrozenCuckooHash::load(image), std::runtime_error);
+    std::stringstream truncated(image.str().substr(0, 100));
+    ASSERT_THROW(FrozenCuckooHash64::load(truncated), std::runtime_error);
+
+    // a corrupt bucket count is rejected before anything that size is allocated
+    std::string corrupt = image.str();
+    uint64_t huge_buckets = uint64_t{1} << 50;
+    std::memcpy(corrupt.data() + 3 * sizeof(uint64_t), &huge_buckets, sizeof(huge_buckets));
+    std::stringstream corrupt_image(corrupt);
+    ASSERT_THROW(FrozenCuckooHash64::load(corrupt_image), std::runtime_error);
+}
+
+// <-----------------------------------------------------------------STATIC SET TESTS-------------------------------------------------------------->
+
+namespace{
+    constexpr auto opcodes = make_static_cuckoo_set({0x00, 0x01, 0x10, 0x1f, 0x20, 0x7f, 0x80, 0xfe, 0xff, -1});
+
+    constexpr std::array<int64_t, 300> reserved_keys(){
+        std::array<int64_t, 300> keys{};
+        for (int64_t i = 0; i < 300; ++i) keys[i] = i * i * 7'919 - (int64_t{1} << 40);
+        return keys;
+    }
+
+    // built by the compiler, so no constructor runs at startup
+    constinit StaticCuckooSet<int64_t, 300> reserved(reserved_keys());
+}
+
+// checked entirely at compile time
+static_assert(opcodes.contains(0x7f) != -1);
+static_assert(opcodes.contains(-1) != -1);
+static_assert(opcodes.contains(0x02) == -1);
+static_assert(opcodes.size() == 10);
+static_assert(*opcodes.find(0x80) == 0x80);
+
+TEST(static_set_tests, compile_time_lookup_table) {
+    for (int k = -300; k < 300; ++k) {
+        bool expected = k == 0x00 || k == 0x01 || k == 0x10 || k == 0x1f || k == 0x20
+                        || k == 0x7f || k == 0x80 || k == 0xfe || k == 0xff || k == -1;
+        ASSERT_EQ(opcodes.contains(k) != -1, expected);
+    }
+}
+
+TEST(static_set_tests, constinit_64bit_set) {
+    std::array<int64_t, 300> keys = reserved_keys();
+    std::unordered_set<int64_t> standard(keys.begin(), keys.end());
+
+    ASSERT_EQ(reserved.size(), 300);
+    for (int64_t k : keys) {
+        ASSERT_NE(reserved.contains(k), -1);
+        ASSERT_EQ(reserved.contains(k + 1) != -1, standard.contains(k + 1));
+    }
+}
+
+// <-----------------------------------------------------------------HASH JOIN TESTS-------------------------------------------------------------->
+
+namespace{
+    using row_pairs = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    row_pairs nested_loop_join(const std::vector<int>& build, const std::vector<int>& probe){
+        row_pairs expected;
+        for (uint32_t p = 0; p < probe.size(); ++p){
+            for (uint32_t b = 0; b < build.size(); ++b){
+                if (build[b] == probe[p]) expected.emplace_back(b, p);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        return expected;
+    }
+
+    row_pairs collect(const std::vector<HashJoin::Partition>& partitions){
+        row_pairs pairs;
+        for (const auto& partition : partitions){
+            for (size_t i = 0; i < partition.build_rows.size(); ++i){
+                pairs.emplace_back(partition.build_rows[i], partition.probe_rows[i]);
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+}
+
+TEST(hash_join_tests, matches_nested_loop_join) {
+    // duplicates on both sides, negative keys and keys with no partner
+    std::vector<int> build{5, -3, 8, 5, 12, 5, -3, 100};
+    std::vector<int> probe{5, 7, -3, 12, 12, 0, 100, 5, -100};
+
+    HashJoin join(build);
+    ASSERT_EQ(join.distinct_keys(), 5);
+    ASSERT_EQ(join.max_matches_per_row(), 3);
+
+    ASSERT_EQ(collect(join.join(probe)), nested_loop_join(build, probe));
+}
+
+TEST(hash_join_tests, probe_resumes_when_output_is_full) {
+    std::vector<int> build{1, 1, 1, 2, 3};
+    std::vector<int> probe{1, 2, 1, 3, 4, 1};
+    HashJoin join(build);
+
+    // room for exactly one group of three per call
+    uint32_t out_build[3], out_probe[3];
+    row_pairs pairs;
+    size_t pos = 0;
+    while (pos < probe.size()) {
+        size_t consumed = 0;
+        size_t written = join.probe(probe.data() + pos, probe.size() - pos, pos, out_build, out_probe, 3, &consumed);
+        ASSERT_GT(consumed, 0);
+        for (size_t i = 0; i < written; ++i) pairs.emplace_back(out_build[i], out_probe[i]);
+        pos += consumed;
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    ASSERT_EQ(pairs, nested_loop_join(build, probe));
+}
+
+TEST(hash_join_tests, parallel_partitions) {
+    std::mt19937 gen(1388230758);// NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<int> dist(0, 2'000);
+    std::vector<int> build(3'000), probe(5'000);
+    for (int& k : build) k = dist(gen);
+    for (int& k : probe) k = dist(gen);
+
+    HashJoin join(build);
+    auto partitions = join.join(probe, 4);
+
+    ASSERT_EQ(partitions.size(), 4);
+    ASSERT_EQ(collect(partitions), nested_loop_join(build, probe));
+}
+
+// <-----------------------------------------------------------------GROUP BY TESTS-------------------------------------------------------------->
+
+TEST(group_by_tests, accumulator_map_upsert_in_place) {
+    AccumulatorMap map;
+    std::unordered_map<int, Accumulator> standard;
+
+    std::mt19937 gen(1388230758);// NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<int> keys(-5'000, 5'000);
+    for (int i = 0; i < 200'000; ++i) {
+        int key = keys(gen);
+        map.upsert(key).add(i);
+        standard[key].add(i);
+    }
+
+    ASSERT_EQ(map.size(), standard.size());
+    ASSERT_GE(map.times_rehashed(), 1);
+    for (const auto& [key, acc] : standard) {
+        const Accumulator* found = map.find(key);
+        ASSERT_NE(found, nullptr);
+        ASSERT_EQ(found->count, acc.count);
+        ASSERT_EQ(found->sum, acc.sum);
+    }
+    ASSERT_EQ(map.find(5'001), nullptr);
+
+    // updating an existing key returns the same accumulator and adds no group
+    Accumulator& hot = map.upsert(0);
+    int64_t before = hot.count;
+    map.upsert(0).add(1);
+    ASSERT_EQ(hot.count, before + 1);
+    ASSERT_EQ(map.size(), standard.size());
+}
+
+TEST(group_by_tests, parallel_group_by_matches_serial) {
+    std::mt19937_64 gen(1388230758);// NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<int> uniform(0, 50'000);
+    std::vector<int> keys(400'000);
+    std::vector<int64_t> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        // a quarter of the rows hit one hot key
+        keys[i] = i % 4 == 0 ? 7 : uniform(gen);
+        values[i] = static_cast<int64_t>(i % 1'000) - 500;
+    }
+
+    std::unordered_map<int, Accumulator> standard;
+    for (size_t i = 0; i < keys.size(); ++i) standard[keys[i]].add(values[i]);
+
+    GroupBy group_by(4);
+    // two batches, the second merges into the first
+    std::vector<int> first_keys(keys.begin(), keys.begin() + 150'000), second_keys(keys.begin() + 150'000, keys.end());
+    std::vector<int64_t> first_values(values.begin(), values.begin() + 150'000), second_values(values.begin() + 150'000, values.end());
+    group_by.run(first_keys, first_values);
+    group_by.run(second_keys, second_values);
+
+    ASSERT_EQ(group_by.partition_count(), 16);
+    ASSERT_EQ(group_by.size(), standard.size());
+    for (const auto& [key, acc] : standard) {
+        const Accumulator* found = group_by.find(key);
+        ASSERT_NE(found, nullptr);
+        ASSERT_EQ(found->count, acc.count);
+        ASSERT_EQ(found->sum, acc.sum);
+    }
+
+    size_t groups = 0;
+    group_by.for_each([&](int, const Accumulator&) { ++groups; });
+    ASSERT_EQ(groups, standard.size());
+}
+
+TEST(group_by_tests, group_by_64bit_keys) {
+    GroupBy64 group_by(2, 3);
+    std::vector<int64_t> keys{int64_t{1} << 40, -1, int64_t{1} << 40, (int64_t{1} << 40) + 1};
+    std::vector<int64_t> values{10, 20, 30, 40};
+    group_by.run(keys, values);
+
+    ASSERT_EQ(group_by.size(), 3);
+    ASSERT_EQ(group_by.find(int64_t{1} << 40)->count, 2);
+    ASSERT_EQ(group_by.find(int64_t{1} << 40)->sum, 40);
+    ASSERT_EQ(group_by.find(-1)->sum, 20);
+    ASSERT_EQ(group_by.find(0), nullptr);
+
+    // a value column shorter than the key column is rejected before anything is aggregated
+    values.pop_back();
+    ASSERT_THROW(group_by.run(keys, values), std::invalid_argument);
+    ASSERT_EQ(group_by.find(int64_t{1} << 40)->count, 2);
+}
+
+// <-----------------------------------------------------------------SHARED MEMORY TESTS----------------------------------------------------------->
+
+#ifdef CUCKOO_HAVE_SHM
+TEST(shared_memory_tests, reader_sees_writer_keys) {
+    std::string name = "/cuckoo_test_" + std::to_string(getpid());
+    auto writer = SharedCuckooHash::create(name);
+    for (int i = 0; i < 1000; ++i) writer.insert(i * 7);
+    ASSERT_EQ(writer.size(), 1000);
+    ASSERT_GT(writer.times_rehashed(), 0);
+
+    auto reader = SharedCuckooHash::open(name);
+    ASSERT_EQ(reader.size(), 1000);
+    for (int i = 0; i < 1000; ++i) ASSERT_NE(reader.contains(i * 7), -1);
+    ASSERT_EQ(reader.contains(1), -1);
+    ASSERT_THROW(reader.insert(1), std::logic_error);
+
+    // the reader remaps once the writer grows the segment
+    for (int i = 1000; i < 5000; ++i) writer.insert(i * 7);
+    ASSERT_TRUE(writer.erase(0));
+    ASSERT_FALSE(writer.erase(0));
+    ASSERT_EQ(reader.size(), 4999);
+    ASSERT_EQ(reader.capacity(), writer.capacity());
+    for (int i = 1; i < 5000; ++i) ASSERT_EQ(reader.find(i * 7), i * 7);
+    ASSERT_EQ(reader.contains(0), -1);
+
+    ASSERT_THROW(SharedCuckooHash64::open(name), std::runtime_error);
+    SharedCuckooHash::unlink(name);
+    ASSERT_THROW(SharedCuckooHash::open(name), std::system_error);
+}
+
+TEST(shared_memory_tests, forked_reader_during_writes) {
+    std::string name = "/cuckoo_test_fork_" + std::to_string(getpid());
+    auto writer = SharedCuckooHash64::create(name, 1000);
+    for (int64_t i = 0; i < 1000; ++i) writer.insert(i << 33);
+
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        // the first 1000 keys must stay visible through every eviction, reseed and growth in the parent
+        int status = 0;
+        try {
+            auto reader = SharedCuckooHash64::open(name);
+            for (int round = 0; round < 50 && status == 0; ++round) {
+                for (int64_t i = 0; i < 1000; ++i) {
+                    if (reader.contains(i << 33) == -1) status = 1;
+                }
+            }
+        } catch (...) {
+            status = 2;
+        }
+        _exit(status);
+    }
+
+    for (int64_t i = 1000; i < 20000; ++i) writer.insert(i << 33);
+    int status = 0;
+    waitpid(child, &status, 0);
+    SharedCuckooHash64::unlink(name);
+
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_EQ(writer.size(), 20000);
+    ASSERT_EQ(writer.sequence() % 2, 0);
+}
+#endif
+
+// <-----------------------------------------------------------------BULK OPERATION TESTS---------------------------------------------------------->
+
+TEST(bulk_operation_tests, iterator_visits_every_key_once) {
+    CuckooHash empty;
+    ASSERT_TRUE(empty.begin() == empty.end());
+
+    CuckooHash table;
+    std::unordered_set<int> expected = random_set(2000, -100000, 100000);
+    for (int key : expected) table.insert(key);
+    table.erase(*expected.begin());
+    expected.erase(expected.begin());
+
+    std::unordered_set<int> seen;
+    for (int key : table) ASSERT_TRUE(seen.insert(key).second);
+    ASSERT_EQ(seen, expected);
+    ASSERT_EQ(static_cast<size_t>(std::distance(table.begin(), table.end())), table.size());
+}
+
+TEST(bulk_operation_tests, erase_if) {
+    RandCuckooHash64 table(0, 7, true);
+    for (int64_t i = 0; i < 3000; ++i) table.insert(i * 1'000'003);
+
+    size_t erased = table.erase_if([](int64_t key) { return key % 2 == 0; });
+    ASSERT_EQ(erased, 1500);
+    ASSERT_EQ(table.size(), 1500);
+    for (int64_t i = 0; i < 3000; ++i) ASSERT_EQ(table.contains(i * 1'000'003) != -1, i % 2 == 1);
+    for (int64_t key : table) ASSERT_EQ(key % 2, 1);
+
+    // erased slots are reusable and visible to the iterator again
+    table.insert(0);
+    ASSERT_EQ(std::count(table.begin(), table.end(), 0), 1);
+    ASSERT_EQ(table.erase_if([](int64_t) { return false; }), 0);
+}
+
+TEST(bulk_operation_tests, set_operations) {
+    RandCuckooHash a(0, 1, true), b(0, 2, true);
+    for (int i = 0; i < 1000; ++i) a.insert(i);
+    for (int i = 900; i < 1200; ++i) b.insert(i);
+
+    auto to_set = [](const RandCuckooHash& table) { return std::unordered_set<int>(table.begin(), table.end()); };
+
+    RandCuckooHash united = table_union(a, b);
+    RandCuckooHash common = table_intersection(a, b);
+    RandCuckooHash a_only = table_difference(a, b);
+    RandCuckooHash b_only = table_difference(b, a);
+
+    ASSERT_EQ(united.size(), 1200);
+    ASSERT_EQ(common.size(), 100);
+    ASSERT_EQ(a_only.size(), 900);
+    ASSERT_EQ(b_only.size(), 200);
+    for (int i = 0; i < 1200; ++i){
+        ASSERT_NE(united.contains(i), -1);
+        ASSERT_EQ(common.contains(i) != -1, i >= 900 && i < 1000);
+        ASSERT_EQ(a_only.contains(i) != -1, i < 900);
+        ASSERT_EQ(b_only.contains(i) != -1, i >= 1000);
+    }
+    ASSERT_EQ(to_set(common).size(), 100);
+
+    // operands are untouched
+    ASSERT_EQ(a.size(), 1000);
+    ASSERT_EQ(b.size(), 300);
+}
+
+// <-----------------------------------------------------------------CACHE TESTS----------------------------------------------------------------->
+
+namespace{
+    //Hand-driven clock for TTL tests
+    struct FakeClock{
+        using duration = std::chrono::nanoseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static inline time_point current{};
+        static time_point now(){ return current; }
+    };
+}
+
+TEST(cuckoo_cache_tests, evicts_instead_of_growing) {
+    CuckooCache<int> cache(3, 11);
+    size_t capacity = cache.capacity();
+
+    for (int i = 0; i < 10000; ++i){
+        cache.insert(i, i * 2);
+        //the newest key always gets a slot
+        ASSERT_EQ(cache.find(i), i * 2);
+    }
+    ASSERT_EQ(cache.capacity(), capacity);
+    ASSERT_LE(cache.size(), capacity);
+    ASSERT_GT(cache.load_factor(), 0.9);
+    ASSERT_EQ(cache.evictions(), 10000 - cache.size());
+
+    size_t present = 0;
+    for (int i = 0; i < 10000; ++i) present += cache.find(i).has_value();
+    ASSERT_EQ(present, cache.size());
+
+    cache.insert(9999, 1);
+    ASSERT_EQ(cache.find(9999), 1);
+    ASSERT_TRUE(cache.erase(9999));
+    ASSERT_FALSE(cache.find(9999).has_value());
+}
+
+TEST(cuckoo_cache_tests, second_chance_keeps_hot_keys) {
+    CuckooCache64<int64_t> cache(4, 5);
+    std::vector<int64_t> hot{3, 17, 99, 1'000'000'007, -5};
+    for (int64_t key : hot) cache.insert(key, key);
+
+    for (int64_t i = 0; i < 20000; ++i){
+        cache.insert(i * 1'000'003 + 1, i);
+        for (int64_t key : hot) ASSERT_EQ(cache.find(key), key);
+    }
+    ASSERT_GT(cache.evictions(), 0);
+    ASSERT_GT(cache.hit_ratio(), 0.8);
+}
+
+TEST(cuckoo_cache_tests, entries_expire_after_ttl) {
+    using namespace std::chrono_literals;
+    FakeClock::current = FakeClock::time_point{};
+    BasicCuckooCache<int, std::string, FakeClock> cache(2, 3);
+
+    cache.insert(1, "short", 10s);
+    cache.insert(2, "forever");
+    cache.insert(3, "long", 1h);
+    ASSERT_EQ(cache.find(1), "short");
+
+    FakeClock::current += 11s;
+    ASSERT_FALSE(cache.find(1).has_value());
+    ASSERT_EQ(cache.expirations(), 1);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.find(2), "forever");
+    ASSERT_EQ(cache.find(3), "long");
+
+    //re-inserting refreshes the TTL
+    cache.insert(3, "renewed", 1h);
+    FakeClock::current += 50min;
+    ASSERT_EQ(cache.find(3), "renewed");
+    FakeClock::current += 20min;
+    ASSERT_FALSE(cache.find(3).has_value());
+    ASSERT_EQ(cache.evictions(), 0);
+}
+
+// <-----------------------------------------------------------------LOCALITY TESTS-------------------------------------------------------------->
+
+TEST(local_cuckoo_tests, insert_find_erase) {
+    LocalCuckooHash table(0, 3);
+    std::unordered_set<int> values = random_set(100'000, INT_MIN, INT_MAX);
+    for (int x : values) table.insert(x);
+    for (int x : values) table.insert(x);
+
+    ASSERT_EQ(table.size(), values.size());
+    ASSERT_LE(table.load_factor(), 0.5f);
+    ASSERT_EQ(table.capacity() % LocalCuckooHash::window_slots, 0);
+    for (int x : values) ASSERT_EQ(table.find(x), x);
+
+    size_t erased = 0;
+    for (int x : values){
+        if (x % 2 == 0) erased += table.erase(x);
+    }
+    ASSERT_EQ(table.size(), values.size() - erased);
+    for (int x : values) ASSERT_EQ(table.contains(x) != -1, x % 2 != 0);
+    for (int x : values){
+        if (x % 2 == 0){
+            ASSERT_FALSE(table.erase(x));
+            break;
+        }
+    }
+}
+
+TEST(local_cuckoo_tests, grows_when_chains_fail) {
+    //with no load limit only a failed eviction chain can trigger growth
+    LocalCuckooHash64 table(10, 9, 1.0f);
+    size_t capacity = table.capacity();
+    for (int64_t i = 0; i < 40'000; ++i) table.insert(i << 20);
+
+    ASSERT_GT(table.times_rehashed(), 0);
+    ASSERT_GT(table.capacity(), capacity);
+    ASSERT_EQ(table.size(), 40'000);
+    for (int64_t i = 0; i < 40'000; ++i) ASSERT_NE(table.contains(i << 20), -1);
+    ASSERT_EQ(table.contains(1), -1);
+}
+
+// <-----------------------------------------------------------------STRING KEY TESTS-------------------------------------------------------------->
+
+TEST(string_cuckoo_tests, heterogeneous_lookup) {
+    StringCuckooHash table(0, 5);
+    std::vector<std::string> words;
+    for (int i = 0; i < 50'000; ++i) words.push_back("key-" + std::to_string(i) + std::string(i % 37, 'x'));
+    for (const std::string& w : words) table.insert(w);
+    for (const std::string& w : words) table.insert(std::string_view(w));
+
+    ASSERT_EQ(table.size(), words.size());
+    ASSERT_GT(table.times_rehashed(), 0);
+    for (const std::string& w : words){
+        std::optional<std::string_view> stored = table.find(w);
+        ASSERT_TRUE(stored.has_value());
+        ASSERT_EQ(*stored, w);
+        //the stored copy lives in the table's arena, not in the probe
+        ASSERT_NE(stored->data(), w.data());
+    }
+    ASSERT_NE(table.contains("key-7xxxxxxx"), -1);
+    ASSERT_EQ(table.contains("key-7"), -1);
+    ASSERT_EQ(table.contains(""), -1);
+
+    table.insert("");
+    ASSERT_NE(table.contains(""), -1);
+    ASSERT_EQ(table.find(""), std::string_view());
+}
+
+TEST(string_cuckoo_tests, erase_compacts_arena) {
+    StringCuckooHash table(12, 8);
+    std::vector<std::string> words;
+    for (int i = 0; i < 20'000; ++i) words.push_back(std::to_string(i * 7919) + "/value");
+    for (const std::string& w : words) table.insert(w);
+    int rehashes = table.times_rehashed();
+    size_t full_arena = table.arena_bytes();
+
+    for (size_t i = 0; i < words.size(); ++i){
+        if (i % 4 != 0) {
+            ASSERT_TRUE(table.erase(words[i]));
+        }
+    }
+    ASSERT_FALSE(table.erase(words[1]));
+    ASSERT_EQ(table.size(), words.size() / 4);
+    ASSERT_LT(table.arena_bytes(), full_arena / 2);
+    ASSERT_EQ(table.times_rehashed(), rehashes);
+    for (size_t i = 0; i < words.size(); ++i) ASSERT_EQ(table.contains(words[i]) != -1, i % 4 == 0);
+
+    //reinserting from a view of the erased key's bytes, still in the table's own arena
+    std::string_view kept = *table.find(words[0]);
+    ASSERT_TRUE(table.erase(kept));
+    table.insert(kept);
+    ASSERT_EQ(table.find(words[0]), words[0]);
+}
+
+// <-----------------------------------------------------------------TRY INSERT TESTS-------------------------------------------------------------->
+
+TEST(try_insert_tests, reports_status_without_rehashing) {
+    CuckooHash table(0);
+    using result = CuckooHash::insert_result;
+
+    //capacity 26 at max load 0.5 takes 13 keys
+    int k = 0;
+    while (table.try_insert(k * 3) == result::inserted) ++k;
+    ASSERT_EQ(k, 13);
+    ASSERT_EQ(table.size(), 13);
+    ASSERT_EQ(table.times_rehashed(), 0);
+    ASSERT_EQ(table.try_insert(0), result::already_present);
+    ASSERT_EQ(table.try_insert(k * 3), result::needs_growth);
+    ASSERT_EQ(table.contains(k * 3), -1);
+
+    table.grow();
+    ASSERT_EQ(table.times_rehashed(), 1);
+    ASSERT_EQ(table.capacity(), 58);
+    ASSERT_EQ(table.try_insert(k * 3), result::inserted);
+    for (int i = 0; i <= k; ++i) ASSERT_NE(table.contains(i * 3), -1);
+}
+
+TEST(try_insert_tests, failed_chain_leaves_table_unchanged) {
+    //0, 13 and 26 share both hash values at capacity 13, so the third has nowhere to go
+    CuckooHash table(0);
+    using result = CuckooHash::insert_result;
+    ASSERT_EQ(table.try_insert(5), result::inserted);
+    ASSERT_EQ(table.try_insert(0), result::inserted);
+    ASSERT_EQ(table.try_insert(13), result::inserted);
+    auto h1 = table.h1_bucket();
+    auto h2 = table.h2_bucket();
+
+    ASSERT_EQ(table.try_insert(26), result::needs_growth);
+    ASSERT_EQ(table.h1_bucket(), h1);
+    ASSERT_EQ(table.h2_bucket(), h2);
+    ASSERT_EQ(table.size(), 3);
+    ASSERT_EQ(table.times_rehashed(), 0);
+    ASSERT_EQ(std::distance(table.begin(), table.end()), 3);
+
+    //plain insert still rebuilds as before
+    table.insert(26);
+    ASSERT_EQ(table.times_rehashed(), 1);
+    for (int key : {5, 0, 13, 26}) ASSERT_NE(table.contains(key), -1);
+}
+
+TEST(try_insert_tests, rebuild_climbs_ladder_in_one_loop) {
+    //multiples of 13 * 29 * 59 * 127 share both hash values at each of the first four capacities,
+    //so the rebuild itself keeps failing until it reaches 257 slots per array
+    CuckooHash table(0);
+    const int64_t step = 13 * 29 * 59 * 127;
+    for (int64_t i = 1; i <= 3; ++i) table.insert(static_cast<int>(i * step));
+
+    ASSERT_EQ(table.capacity(), 2 * 257);
+    ASSERT_EQ(table.times_rehashed(), 4);
+    ASSERT_EQ(table.size(), 3);
+    for (int64_t i = 1; i <= 3; ++i) ASSERT_NE(table.contains(static_cast<int>(i * step)), -1);
+}
+
+// <-----------------------------------------------------------------KEYED HASH TESTS-------------------------------------------------------------->
+
+TEST(keyed_cuckoo_tests, adversarial_keys) {
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<int32_t> int32_range(-2'147'483'647, 2'147'483'647);
+    int32_t key = int32_range(gen);
+
+    CuckooHash table(0);
+    KeyedCuckooHash keyed_table(0);
+
+    // same sequence that forces the deterministic table up the sizes ladder
+    std::vector<int32_t> inserted;
+    for (int i = 0; i < 25; i++) {
+        key += (int) table.capacity() / 2;
+        keyed_table.insert(key);
+        inserted.push_back(key);
+    }
+
+    // only the load factor should force growth, and every key must still be present
+    EXPECT_EQ(keyed_table.times_rehashed(), 1);
+    EXPECT_EQ(keyed_table.size(), 25);
+    for (int32_t k : inserted) EXPECT_NE(keyed_table.contains(k), -1);
+}
+
+TEST(keyed_cuckoo_tests, chain_blowup_reseeds_in_place) {
+    // seed chosen so that one of these inserts exceeds max steps at half load
+    KeyedCuckooHash table(0, 17);
+
+    for (int k = 0; k < 13; k++) {
+        table.insert(k * 13);
+    }
+
+    EXPECT_GE(table.times_reseeded(), 1);
+    EXPECT_EQ(table.times_rehashed(), 0);
+    ASSERT_EQ(table.capacity(), 26);
+    ASSERT_EQ(table.size(), 13);
+
+    for (int k = 0; k < 13; k++) {
+        ASSERT_TRUE(table.contains(k * 13) == 1 || table.contains(k * 13) == 2);
+    }
+}
+
 int main(int argc, char *argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,426 @@
+#include "frozen_cuckoo_hash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Command line front end for building membership sets from key files and querying them from pipes.
+//
+//     cuckoo_tool build KEYS -o TABLE [--binary] [--threads=N]
+//     cuckoo_tool query TABLE [--binary] [--hits] < queries > answers
+//
+// build maps KEYS, parses it on N threads (each thread sorting and deduplicating its share), merges
+// the shares and freezes them into a FrozenCuckooHash64, which is saved to TABLE. Text key files hold
+// signed decimal 64-bit keys separated by any whitespace; with --binary they are raw native-endian
+// int64 values. The ingest rate is reported on stderr.
+//
+// query loads TABLE and answers keys read from stdin, one per line (blank lines are skipped), in
+// batches that prefetch every probe before checking it. It prints 1 or 0 per key, or with --hits
+// echoes only the lines that are members, written with writev straight out of the input buffer.
+// With --binary, stdin holds raw int64 keys and the answer is one 0/1 byte per key.
+//
+// POSIX only (mmap, read/write, writev).
+
+namespace {
+    using tool_clock = std::chrono::steady_clock;
+    using Table = FrozenCuckooHash64;
+
+    constexpr size_t read_chunk = 1 << 20;
+    constexpr size_t batch_size = 64;
+
+    double seconds_since(tool_clock::time_point start) {
+        return std::chrono::duration<double>(tool_clock::now() - start).count();
+    }
+
+    [[noreturn]] void fail_errno(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void usage() {
+        std::cerr << "usage: cuckoo_tool build KEYS -o TABLE [--binary] [--threads=N]\n"
+                     "       cuckoo_tool query TABLE [--binary] [--hits]\n";
+    }
+
+    void write_all(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                fail_errno("write");
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    // Read-only mapping of a whole file
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) fail_errno("open " + path);
+            struct stat st{};
+            if (fstat(fd, &st) == -1) {
+                ::close(fd);
+                fail_errno("fstat " + path);
+            }
+            length = static_cast<size_t>(st.st_size);
+            if (length > 0) {
+                void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    ::close(fd);
+                    fail_errno("mmap " + path);
+                }
+                madvise(mapped, length, MADV_SEQUENTIAL);
+                bytes = static_cast<const char*>(mapped);
+            }
+            ::close(fd);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            if (bytes) munmap(const_cast<char*>(bytes), length);
+        }
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+
+    private:
+        const char* bytes{nullptr};
+        size_t length{0};
+    };
+
+    bool is_space(char c) {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+
+    // parses whitespace-separated decimal keys in [begin, end)
+    void parse_text(const char* begin, const char* end, std::vector<int64_t>& out) {
+        const char* p = begin;
+        while (true) {
+            while (p < end && is_space(*p)) ++p;
+            if (p == end) return;
+            int64_t key;
+            auto [next, error] = std::from_chars(p, end, key);
+            if (error != std::errc() || (next < end && !is_space(*next))) {
+                const char* token_end = p;
+                while (token_end < end && !is_space(*token_end) && token_end - p < 20) ++token_end;
+                throw std::invalid_argument("bad key \"" + std::string(p, token_end) + "\"");
+            }
+            out.push_back(key);
+            p = next;
+        }
+    }
+
+    // every thread parses, sorts and deduplicates one share of the file, then the shares are merged
+    std::vector<int64_t> load_keys(const MappedFile& file, bool binary, unsigned threads, std::atomic<size_t>& parsed) {
+        const char* data = file.data();
+        size_t size = file.size();
+        if (binary && size % sizeof(int64_t) != 0) throw std::invalid_argument("binary key file size is not a multiple of 8");
+
+        // share boundaries, moved forward to the next key boundary
+        std::vector<size_t> bounds(threads + 1, size);
+        bounds[0] = 0;
+        for (unsigned t = 1; t < threads; ++t) {
+            size_t at = size / threads * t;
+            if (binary) at -= at % sizeof(int64_t);
+            else while (at > 0 && at < size && !is_space(data[at - 1])) ++at;
+            bounds[t] = std::max(at, bounds[t - 1]);
+        }
+
+        std::vector<std::vector<int64_t>> shares(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                try {
+                    std::vector<int64_t>& share = shares[t];
+                    if (binary) {
+                        share.resize((bounds[t + 1] - bounds[t]) / sizeof(int64_t));
+                        std::memcpy(share.data(), data + bounds[t], share.size() * sizeof(int64_t));
+                    } else {
+                        // keys of 7+ digits plus a separator take at least 8 bytes each
+                        share.reserve((bounds[t + 1] - bounds[t]) / 8);
+                        parse_text(data + bounds[t], data + bounds[t + 1], share);
+                    }
+                    parsed += share.size();
+                    std::sort(share.begin(), share.end());
+                    share.erase(std::unique(share.begin(), share.end()), share.end());
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        std::vector<int64_t> keys;
+        size_t distinct_upper = 0;
+        for (const auto& share : shares) distinct_upper += share.size();
+        keys.reserve(distinct_upper);
+        for (auto& share : shares) {
+            size_t middle = keys.size();
+            keys.insert(keys.end(), share.begin(), share.end());
+            share = {};
+            std::inplace_merge(keys.begin(), keys.begin() + static_cast<ptrdiff_t>(middle), keys.end());
+        }
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    int build(const std::string& keys_path, const std::string& table_path, bool binary, unsigned threads) {
+        auto start = tool_clock::now();
+        MappedFile file(keys_path);
+        std::atomic<size_t> parsed{0};
+        std::vector<int64_t> keys = load_keys(file, binary, threads, parsed);
+        double parse_s = seconds_since(start);
+
+        start = tool_clock::now();
+        Table table(keys);
+        double build_s = seconds_since(start);
+
+        start = tool_clock::now();
+        std::ofstream out(table_path, std::ios::binary);
+        if (!out) throw std::runtime_error("cannot create " + table_path);
+        table.save(out);
+        out.close();
+        double save_s = seconds_since(start);
+
+        double total_s = parse_s + build_s + save_s;
+        std::cerr << "ingested " << parsed.load() << " keys (" << keys.size() << " distinct) from " << keys_path
+                  << " with " << threads << " threads\n"
+                  << "  parse " << parse_s << " s, build " << build_s << " s (load " << table.load_factor()
+                  << "), save " << save_s << " s\n"
+                  << "  " << static_cast<double>(parsed.load()) / total_s << " keys/s\n";
+        return 0;
+    }
+
+    // answers raw int64 keys with one 0/1 byte each
+    size_t query_binary(Table& table, size_t& hits) {
+        std::vector<char> in(read_chunk + sizeof(int64_t));
+        std::vector<char> out;
+        out.reserve(read_chunk / sizeof(int64_t));
+        size_t carry = 0, queries = 0;
+
+        while (true) {
+            ssize_t got = ::read(STDIN_FILENO, in.data() + carry, read_chunk);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                fail_errno("read stdin");
+            }
+            size_t available = carry + static_cast<size_t>(got);
+            size_t count = available / sizeof(int64_t);
+
+            const char* p = in.data();
+            for (size_t start = 0; start < count; start += batch_size) {
+                size_t n = std::min(batch_size, count - start);
+                int64_t keys[batch_size];
+                std::memcpy(keys, p + start * sizeof(int64_t), n * sizeof(int64_t));
+                for (size_t i = 0; i < n; ++i) table.prefetch(keys[i]);
+                for (size_t i = 0; i < n; ++i) {
+                    bool hit = table.contains(keys[i]) != -1;
+                    hits += hit;
+                    out.push_back(hit ? 1 : 0);
+                }
+            }
+            queries += count;
+            write_all(STDOUT_FILENO, out.data(), out.size());
+            out.clear();
+
+            carry = available - count * sizeof(int64_t);
+            std::memmove(in.data(), in.data() + count * sizeof(int64_t), carry);
+            if (got == 0) {
+                if (carry != 0) throw std::invalid_argument("binary query stream ends in a partial key");
+                return queries;
+            }
+        }
+    }
+
+    // answers one key per line, either 1/0 per key or, with hits_only, the member lines themselves
+    size_t query_text(Table& table, bool hits_only, size_t& hits) {
+        std::vector<char> in(read_chunk + 1);
+        std::string out;
+        out.reserve(read_chunk / 4);
+        // member lines as slices of the input buffer, adjacent lines merged into one slice
+        std::vector<iovec> slices;
+        size_t carry = 0, queries = 0;
+
+        struct Line {
+            const char* begin;
+            const char* end;
+            int64_t key;
+        };
+        std::vector<Line> lines;
+
+        auto flush_slices = [&] {
+            for (size_t first = 0; first < slices.size();) {
+                int count = static_cast<int>(std::min<size_t>(slices.size() - first, IOV_MAX));
+                ssize_t written = ::writev(STDOUT_FILENO, slices.data() + first, count);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    fail_errno("writev");
+                }
+                // finish any short write slice by slice
+                size_t remaining = static_cast<size_t>(written);
+                int done = 0;
+                while (done < count && remaining >= slices[first + done].iov_len) remaining -= slices[first + done++].iov_len;
+                if (done < count) {
+                    iovec& partial = slices[first + done];
+                    write_all(STDOUT_FILENO, static_cast<const char*>(partial.iov_base) + remaining, partial.iov_len - remaining);
+                    ++done;
+                }
+                first += static_cast<size_t>(done);
+            }
+            slices.clear();
+        };
+
+        auto answer = [&](const char* begin, const char* end) {
+            lines.clear();
+            for (const char* p = begin; p < end;) {
+                const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                const char* line_end = newline ? newline : end;
+                const char* key_begin = p;
+                const char* key_end = line_end;
+                while (key_begin < key_end && is_space(*key_begin)) ++key_begin;
+                while (key_end > key_begin && is_space(key_end[-1])) --key_end;
+                if (key_begin < key_end) {
+                    int64_t key;
+                    auto [next, error] = std::from_chars(key_begin, key_end, key);
+                    if (error != std::errc() || next != key_end) throw std::invalid_argument("bad query \"" + std::string(key_begin, key_end) + "\"");
+                    lines.push_back({p, newline ? newline + 1 : end, key});
+                }
+                p = line_end + 1;
+            }
+
+            for (size_t start = 0; start < lines.size(); start += batch_size) {
+                size_t n = std::min(batch_size, lines.size() - start);
+                for (size_t i = 0; i < n; ++i) table.prefetch(lines[start + i].key);
+                for (size_t i = 0; i < n; ++i) {
+                    const Line& line = lines[start + i];
+                    bool hit = table.contains(line.key) != -1;
+                    hits += hit;
+                    if (!hits_only) {
+                        out += hit ? "1\n" : "0\n";
+                    } else if (hit) {
+                        size_t length = static_cast<size_t>(line.end - line.begin);
+                        if (!slices.empty() && static_cast<const char*>(slices.back().iov_base) + slices.back().iov_len == line.begin) {
+                            slices.back().iov_len += length;
+                        } else {
+                            slices.push_back({const_cast<char*>(line.begin), length});
+                        }
+                        // the last line of the stream may lack its newline
+                        if (line.end[-1] != '\n') slices.push_back({const_cast<char*>("\n"), 1});
+                    }
+                }
+            }
+            queries += lines.size();
+            if (hits_only) flush_slices();
+            else {
+                write_all(STDOUT_FILENO, out.data(), out.size());
+                out.clear();
+            }
+        };
+
+        while (true) {
+            ssize_t got = ::read(STDIN_FILENO, in.data() + carry, in.size() - 1 - carry);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                fail_errno("read stdin");
+            }
+            size_t available = carry + static_cast<size_t>(got);
+            if (got == 0) {
+                answer(in.data(), in.data() + available);
+                return queries;
+            }
+
+            // answer complete lines, keep the partial last line for the next read
+            const char* last_newline = nullptr;
+            for (const char* p = in.data() + available; p > in.data(); --p) {
+                if (p[-1] == '\n') {
+                    last_newline = p;
+                    break;
+                }
+            }
+            if (!last_newline) {
+                if (available == in.size() - 1) in.resize(in.size() * 2);
+                carry = available;
+                continue;
+            }
+            answer(in.data(), last_newline);
+            carry = static_cast<size_t>(in.data() + available - last_newline);
+            std::memmove(in.data(), last_newline, carry);
+        }
+    }
+
+    int query(const std::string& table_path, bool binary, bool hits_only) {
+        auto start = tool_clock::now();
+        std::ifstream in(table_path, std::ios::binary);
+        if (!in) throw std::runtime_error("cannot open " + table_path);
+        Table table = Table::load(in);
+        double load_s = seconds_since(start);
+
+        start = tool_clock::now();
+        size_t hits = 0;
+        size_t queries = binary ? query_binary(table, hits) : query_text(table, hits_only, hits);
+        double query_s = seconds_since(start);
+
+        std::cerr << "loaded " << table.size() << " keys in " << load_s << " s, answered " << queries
+                  << " queries (" << hits << " hits) in " << query_s << " s, "
+                  << static_cast<double>(queries) / query_s << " queries/s\n";
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::string output;
+    bool binary = false, hits_only = false;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--binary") binary = true;
+            else if (arg == "--hits") hits_only = true;
+            else if (arg.rfind("--threads=", 0) == 0) threads = std::max(1, std::stoi(arg.substr(10)));
+            else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+            else if (arg.rfind("-", 0) == 0) throw std::invalid_argument("unknown option " + arg);
+            else positional.push_back(arg);
+        }
+
+        if (positional.size() == 2 && positional[0] == "build" && !output.empty()) {
+            return build(positional[1], output, binary, threads);
+        }
+        if (positional.size() == 2 && positional[0] == "query") {
+            return query(positional[1], binary, hits_only);
+        }
+        usage();
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "cuckoo_tool: " << e.what() << std::endl;
+        return 1;
+    }
+}